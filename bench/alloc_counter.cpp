@@ -0,0 +1,74 @@
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Every block is prefixed with its size so operator delete can keep current_bytes accurate
+constexpr auto header = alignof(std::max_align_t);
+
+std::atomic<std::size_t> allocations = 0;
+std::atomic<std::size_t> bytes = 0;
+std::atomic<std::size_t> current_bytes = 0;
+std::atomic<std::size_t> peak_bytes = 0;
+
+auto allocate(std::size_t n) -> void* {
+    auto p = static_cast<char*>(std::malloc(n + header));
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t*>(p) = n;
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(n, std::memory_order_relaxed);
+    auto current = current_bytes.fetch_add(n, std::memory_order_relaxed) + n;
+    auto peak = peak_bytes.load(std::memory_order_relaxed);
+    while (current > peak && !peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+    return p + header;
+}
+
+void deallocate(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    auto p = static_cast<char*>(ptr) - header;
+    current_bytes.fetch_sub(*reinterpret_cast<std::size_t*>(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+}
+
+auto mee::json::bench::get_alloc_stats() noexcept -> alloc_stats {
+    return {allocations.load(), bytes.load(), current_bytes.load(), peak_bytes.load()};
+}
+
+void mee::json::bench::reset_alloc_stats() noexcept {
+    allocations = 0;
+    bytes = 0;
+    peak_bytes = current_bytes.load();
+}
+
+auto operator new(std::size_t n) -> void* {
+    return allocate(n);
+}
+
+auto operator new[](std::size_t n) -> void* {
+    return allocate(n);
+}
+
+void operator delete(void* p) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    deallocate(p);
+}
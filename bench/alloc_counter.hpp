@@ -0,0 +1,23 @@
+#ifndef JSON_BENCH_ALLOC_COUNTER_HPP
+#define JSON_BENCH_ALLOC_COUNTER_HPP
+
+#include <cstddef>
+
+namespace mee::json::bench {
+
+// Counters maintained by the replacement global operator new/delete in alloc_counter.cpp
+struct alloc_stats {
+    std::size_t allocations;
+    std::size_t bytes;
+    std::size_t current_bytes;
+    std::size_t peak_bytes;
+};
+
+auto get_alloc_stats() noexcept -> alloc_stats;
+
+// Resets the allocation counters and sets the peak to the number of bytes currently live
+void reset_alloc_stats() noexcept;
+
+}
+
+#endif
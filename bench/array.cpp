@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "../include/meejson/parser.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+auto numbers(std::size_t n) -> json::array {
+    return std::move(json::parse(json::bench::numbers_document(n))->get_array());
+}
+
+// The previous layout, one heap node per element, for comparison
+auto boxed_numbers(std::size_t n) -> std::vector<std::unique_ptr<json::value>> {
+    auto boxed = std::vector<std::unique_ptr<json::value>>();
+    for (auto& x : numbers(n)) {
+        boxed.push_back(std::make_unique<json::value>(std::move(x)));
+    }
+    return boxed;
+}
+
+auto to_double(const json::value& x) noexcept -> double {
+    if (auto i = x.get_if_int()) {
+        return double(*i);
+    }
+    return x.get_float();
+}
+
+void iterate_array(benchmark::State& state) {
+    const auto arr = numbers(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (const auto& x : arr) {
+            sum += to_double(x);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * arr.size()));
+}
+
+void iterate_boxed(benchmark::State& state) {
+    const auto arr = boxed_numbers(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (const auto& x : arr) {
+            sum += to_double(*x);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * arr.size()));
+}
+
+void sort_array(benchmark::State& state) {
+    const auto arr = numbers(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto copy = arr;
+        state.ResumeTiming();
+        std::ranges::sort(copy);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * arr.size()));
+}
+
+void sort_boxed(benchmark::State& state) {
+    const auto n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto copy = boxed_numbers(n);
+        state.ResumeTiming();
+        std::ranges::sort(copy, [](const auto& lhs, const auto& rhs) { return *lhs < *rhs; });
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * n));
+}
+
+}
+
+BENCHMARK(iterate_array)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(iterate_boxed)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(sort_array)->Arg(1 << 20)->Iterations(10)->Unit(benchmark::kMillisecond);
+BENCHMARK(sort_boxed)->Arg(1 << 20)->Iterations(10)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/cursor.hpp"
+#include "../include/meejson/lazy.hpp"
+#include "alloc_counter.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+// The same envelope as the lazy benchmarks: a few fields around a large payload
+auto envelope(std::size_t bytes) -> std::string {
+    auto s = std::string(R"({"id": 1234, "meta": {"version": 3, "source": "bench"}, "items": )");
+    s += json::bench::records_document(bytes);
+    s += R"(, "name": "envelope", "status": "ok"})";
+    return s;
+}
+
+void report(benchmark::State& state, std::size_t input_size) {
+    const auto stats = json::bench::get_alloc_stats();
+    state.SetBytesProcessed(std::int64_t(state.iterations() * input_size));
+    state.counters["allocs"] = benchmark::Counter(double(stats.allocations), benchmark::Counter::kAvgIterations);
+}
+
+void fields_cursor(benchmark::State& state) {
+    const auto s = envelope(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto c = json::cursor(s);
+        auto sum = c["id"].get_int() + c["meta"]["version"].get_int();
+        sum += std::int64_t(c["name"].get_string().size() + c["status"].get_string().size());
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, s.size());
+}
+
+// Summing one field of every record, which has to walk the whole payload
+void records_lazy(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        const auto doc = std::move(*json::parse_lazy(s));
+        auto sum = std::int64_t(0);
+        for (const auto record : doc.root().get_array()) {
+            sum += record["id"].get_int();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, s.size());
+}
+
+void records_cursor(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto c = json::cursor(s);
+        auto sum = std::int64_t(0);
+        for (const auto record : c.root().get_array()) {
+            sum += record["id"].get_int();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, s.size());
+}
+
+}
+
+BENCHMARK(fields_cursor)->Arg(50 << 10)->Unit(benchmark::kMicrosecond);
+BENCHMARK(records_lazy)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(records_cursor)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,100 @@
+#ifndef JSON_BENCH_DATA_HPP
+#define JSON_BENCH_DATA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mee::json::bench {
+
+// Deterministic xorshift generator so every run benchmarks identical documents
+struct rng {
+    std::uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    auto operator()() noexcept -> std::uint64_t {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+// An array of small records mixing strings, integers, floats, booleans and nested arrays, roughly
+// shaped like an API response. Approximately `bytes` long.
+inline auto records_document(std::size_t bytes) -> std::string {
+    auto r = rng();
+    auto s = std::string("[");
+    for (auto i = 0u; s.size() < bytes; i++) {
+        if (i != 0) {
+            s += ",\n";
+        }
+        s += R"({"id": )" + std::to_string(i);
+        s += R"(, "name": "user_)" + std::to_string(r() % 100000) + '"';
+        s += R"(, "score": )" + std::to_string(double(r() % 1000000) / 1000.0);
+        s += R"(, "active": )";
+        s += (r() % 2) ? "true" : "false";
+        s += R"(, "tags": ["alpha", "beta", "gamma"], "parent": null})";
+    }
+    s += ']';
+    return s;
+}
+
+// An array of long, mostly escape free strings: URLs, user agents and base64 blobs, with the
+// occasional escaped quote or \\u escape. Approximately `bytes` long.
+inline auto strings_document(std::size_t bytes) -> std::string {
+    constexpr auto alphabet = std::string_view("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+    auto r = rng();
+    auto s = std::string("[");
+    for (auto i = 0u; s.size() < bytes; i++) {
+        if (i != 0) {
+            s += ',';
+        }
+        switch (i % 4) {
+            case 0:
+                s += R"("https://cdn.example.com/assets/)" + std::to_string(r() % 100000) + R"(/image.png?size=large&v=2")";
+                break;
+            case 1:
+                s += R"("Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36")";
+                break;
+            case 2:
+                s += '"';
+                for (auto j = 0; j < 96; j++) {
+                    s += alphabet[r() % alphabet.size()];
+                }
+                s += '"';
+                break;
+            default:
+                s += R"("she said \"hello\" and left \u00e9t\u00e9 \ud83d\ude00")";
+                break;
+        }
+    }
+    s += ']';
+    return s;
+}
+
+// A flat array of `n` integers and floats
+inline auto numbers_document(std::size_t n) -> std::string {
+    auto r = rng();
+    auto s = std::string("[");
+    for (auto i = 0u; i < n; i++) {
+        if (i != 0) {
+            s += ',';
+        }
+        if (i % 2) {
+            s += std::to_string(std::int64_t(r() % 2000000) - 1000000);
+        } else {
+            s += std::to_string(double(r() % 100000000) / 1000.0);
+        }
+    }
+    s += ']';
+    return s;
+}
+
+// `depth` nested arrays around a single integer
+inline auto nested_document(std::size_t depth) -> std::string {
+    return std::string(depth, '[') + "0" + std::string(depth, ']');
+}
+
+}
+
+#endif
@@ -0,0 +1,21 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/lexer.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+void index_structurals(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        auto index = json::detail::index_structurals(s);
+        benchmark::DoNotOptimize(index);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * s.size()));
+}
+
+}
+
+BENCHMARK(index_structurals)->Arg(1 << 16)->Arg(1 << 24)->Unit(benchmark::kMicrosecond);
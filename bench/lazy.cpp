@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/lazy.hpp"
+#include "../include/meejson/parser.hpp"
+#include "alloc_counter.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+// A response whose few interesting fields sit around a large payload
+auto envelope(std::size_t bytes) -> std::string {
+    auto s = std::string(R"({"id": 1234, "meta": {"version": 3, "source": "bench"}, "items": )");
+    s += json::bench::records_document(bytes);
+    s += R"(, "name": "envelope", "status": "ok"})";
+    return s;
+}
+
+void report(benchmark::State& state, std::size_t input_size) {
+    const auto stats = json::bench::get_alloc_stats();
+    state.SetBytesProcessed(std::int64_t(state.iterations() * input_size));
+    state.counters["allocs"] = benchmark::Counter(double(stats.allocations), benchmark::Counter::kAvgIterations);
+}
+
+void fields_full(benchmark::State& state) {
+    const auto s = envelope(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        const auto val = *json::parse(s);
+        auto sum = val["id"].get_int() + val["meta"]["version"].get_int();
+        sum += std::int64_t(val["name"].get_string().size() + val["status"].get_string().size());
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, s.size());
+}
+
+void fields_lazy(benchmark::State& state) {
+    const auto s = envelope(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        const auto doc = std::move(*json::parse_lazy(s));
+        const auto val = doc.root();
+        auto sum = val["id"].get_int() + val["meta"]["version"].get_int();
+        sum += std::int64_t(val["name"].get_string().size() + val["status"].get_string().size());
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, s.size());
+}
+
+}
+
+BENCHMARK(fields_full)->Arg(50 << 10)->Unit(benchmark::kMicrosecond);
+BENCHMARK(fields_lazy)->Arg(50 << 10)->Unit(benchmark::kMicrosecond);
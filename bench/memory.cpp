@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/compact.hpp"
+#include "alloc_counter.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+// Heap bytes held by the parsed tree, per element, and the peak reached while parsing
+template <class Value>
+void retained(benchmark::State& state, const std::string& s, std::size_t elements) {
+    auto held = std::size_t(0);
+    auto peak = std::size_t(0);
+    for (auto _ : state) {
+        json::bench::reset_alloc_stats();
+        const auto before = json::bench::get_alloc_stats().current_bytes;
+        auto val = json::parse<Value>(s);
+        benchmark::DoNotOptimize(val);
+        const auto stats = json::bench::get_alloc_stats();
+        held = stats.current_bytes - before;
+        peak = stats.peak_bytes - before;
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * s.size()));
+    state.counters["bytes_per_element"] = double(held) / double(elements);
+    state.counters["peak_bytes"] = double(peak);
+    state.counters["value_size"] = double(sizeof(Value));
+}
+
+template <class Value>
+void numbers_retained(benchmark::State& state) {
+    const auto n = std::size_t(state.range(0));
+    retained<Value>(state, json::bench::numbers_document(n), n);
+}
+
+// Records are counted as their seven members plus the three tags
+template <class Value>
+void records_retained(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    const auto records = json::parse(s)->get_array().size();
+    retained<Value>(state, s, records * 10);
+}
+
+// Summing touches every element, so it runs at the speed the array streams through the cache
+template <class Value>
+void numbers_sum(benchmark::State& state) {
+    const auto val = *json::parse<Value>(json::bench::numbers_document(std::size_t(state.range(0))));
+    const auto& arr = val.get_array();
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (const auto& x : arr) {
+            if (auto i = x.get_if_int()) {
+                sum += double(*i);
+            } else {
+                sum += x.get_float();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * arr.size()));
+}
+
+}
+
+BENCHMARK(numbers_retained<json::value>)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(numbers_retained<json::compact::value>)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(records_retained<json::value>)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(records_retained<json::compact::value>)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(numbers_sum<json::value>)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(numbers_sum<json::compact::value>)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,244 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/ordered_object.hpp"
+#include "alloc_counter.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+auto key(std::size_t i) -> std::string {
+    return "field_" + std::to_string(i);
+}
+
+template <class Value>
+auto make_object(std::size_t n) -> typename Value::object_type {
+    auto obj = typename Value::object_type();
+    for (auto i = std::size_t(0); i < n; i++) {
+        obj.emplace(key(i), Value(std::int64_t(i)));
+    }
+    return obj;
+}
+
+// Every key looked up once per iteration, plus one miss
+template <class Value>
+void object_lookup(benchmark::State& state) {
+    const auto n = std::size_t(state.range(0));
+    const auto obj = make_object<Value>(n);
+    auto keys = std::vector<std::string>();
+    for (auto i = std::size_t(0); i <= n; i++) {
+        keys.push_back(key(i));
+    }
+    for (auto _ : state) {
+        auto found = std::size_t(0);
+        for (const auto& k : keys) {
+            found += obj.find(k) != obj.end();
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * keys.size()));
+}
+
+// Keys too long for the small string buffer, looked up the way each caller would: by building
+// a key as lookups used to, by view, or by precomputed hash
+auto long_key(std::size_t i) -> std::string {
+    return "a_field_name_beyond_the_small_string_buffer_" + std::to_string(i);
+}
+
+template <class Value, class Lookup>
+void object_lookup_by(benchmark::State& state, Lookup lookup) {
+    const auto n = std::size_t(state.range(0));
+    auto obj = typename Value::object_type();
+    auto keys = std::vector<std::string>();
+    for (auto i = std::size_t(0); i < n; i++) {
+        keys.push_back(long_key(i));
+        obj.emplace(keys.back(), Value(std::int64_t(i)));
+    }
+    auto hashed = std::vector<json::hashed_key>();
+    for (const auto& k : keys) {
+        hashed.emplace_back(k);
+    }
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto found = std::size_t(0);
+        for (auto i = std::size_t(0); i < n; i++) {
+            found += lookup(std::as_const(obj), keys[i], hashed[i]);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * n));
+    state.counters["allocs_per_lookup"] = double(json::bench::get_alloc_stats().allocations) / double(state.iterations() * n);
+}
+
+template <class Value>
+void object_lookup_string(benchmark::State& state) {
+    object_lookup_by<Value>(state, [](const auto& obj, std::string_view k, const json::hashed_key&) {
+        return obj.find(typename Value::string_type(k)) != obj.end();
+    });
+}
+
+template <class Value>
+void object_lookup_view(benchmark::State& state) {
+    object_lookup_by<Value>(state, [](const auto& obj, std::string_view k, const json::hashed_key&) {
+        return obj.find(k) != obj.end();
+    });
+}
+
+template <class Value>
+void object_lookup_hashed(benchmark::State& state) {
+    object_lookup_by<Value>(state, [](const auto& obj, std::string_view, const json::hashed_key& k) {
+        return obj.find(k) != obj.end();
+    });
+}
+
+// A handler reading the same fields out of every record, by view and by compile time key
+void object_fields_view(benchmark::State& state) {
+    const auto val = *json::parse(json::bench::records_document(std::size_t(state.range(0))));
+    const auto& records = val.get_array();
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (const auto& record : records) {
+            sum += double(record["id"].get_int()) + record["score"].get_float();
+            sum += double(record["name"].get_string().size() + record["tags"].get_array().size());
+            sum += double(record["active"].get_bool() + record["parent"].holds<json::null>());
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * records.size() * 6));
+}
+
+void object_fields_key(benchmark::State& state) {
+    using namespace json::literals;
+    const auto val = *json::parse(json::bench::records_document(std::size_t(state.range(0))));
+    const auto& records = val.get_array();
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (const auto& record : records) {
+            sum += double(record["id"_key].get_int()) + record["score"_key].get_float();
+            sum += double(record["name"_key].get_string().size() + record["tags"_key].get_array().size());
+            sum += double(record["active"_key].get_bool() + record["parent"_key].holds<json::null>());
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * records.size() * 6));
+}
+
+// Records where half the optional fields are missing, read by catching invalid_access and without
+// throwing
+auto sparse_records(std::size_t n) -> json::value {
+    auto s = std::string("[");
+    for (auto i = std::size_t(0); i < n; i++) {
+        s += i ? ", " : "";
+        s += "{\"id\": " + std::to_string(i);
+        s += i % 2 ? ", \"score\": 1.5, \"name\": \"x\"}" : "}";
+    }
+    return *json::parse(s + ']');
+}
+
+void object_sparse_throwing(benchmark::State& state) {
+    const auto val = sparse_records(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (const auto& record : val.get_array()) {
+            sum += double(record["id"].get_int());
+            try {
+                sum += record["score"].get_float();
+            } catch (const json::invalid_access&) {}
+            try {
+                sum += double(record["name"].get_string().size());
+            } catch (const json::invalid_access&) {}
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * val.get_array().size() * 3));
+    state.counters["allocs"] = benchmark::Counter(double(json::bench::get_alloc_stats().allocations),
+                                                  benchmark::Counter::kAvgIterations);
+}
+
+void object_sparse_get_or(benchmark::State& state) {
+    const auto val = sparse_records(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (const auto& record : val.get_array()) {
+            sum += double(record.get_or("id", std::int64_t(0)));
+            sum += record.get_or("score", 0.0);
+            sum += double(record.get_or("name", "").size());
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * val.get_array().size() * 3));
+    state.counters["allocs"] = benchmark::Counter(double(json::bench::get_alloc_stats().allocations),
+                                                  benchmark::Counter::kAvgIterations);
+}
+
+template <class Value>
+void object_iterate(benchmark::State& state) {
+    const auto obj = make_object<Value>(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        auto sum = std::int64_t(0);
+        for (const auto& member : obj) {
+            sum += member.second().get_int();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * obj.size()));
+}
+
+template <class Value>
+void object_construct(benchmark::State& state) {
+    const auto n = std::size_t(state.range(0));
+    auto keys = std::vector<std::string>();
+    for (auto i = std::size_t(0); i < n; i++) {
+        keys.push_back(key(i));
+    }
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto obj = typename Value::object_type();
+        for (auto i = std::size_t(0); i < n; i++) {
+            obj.emplace(keys[i], Value(std::int64_t(i)));
+        }
+        benchmark::DoNotOptimize(obj);
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations() * n));
+    state.counters["allocs"] = benchmark::Counter(double(json::bench::get_alloc_stats().allocations),
+                                                  benchmark::Counter::kAvgIterations);
+}
+
+// Whole documents of small records
+template <class Value>
+void object_parse_records(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::parse<Value>(s);
+        benchmark::DoNotOptimize(val);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * s.size()));
+    state.counters["allocs"] = benchmark::Counter(double(json::bench::get_alloc_stats().allocations),
+                                                  benchmark::Counter::kAvgIterations);
+}
+
+}
+
+BENCHMARK(object_lookup<json::value>)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK(object_lookup<json::ordered_value>)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK(object_lookup_string<json::value>)->Arg(16)->Arg(1024);
+BENCHMARK(object_lookup_string<json::ordered_value>)->Arg(16)->Arg(1024);
+BENCHMARK(object_lookup_view<json::value>)->Arg(16)->Arg(1024);
+BENCHMARK(object_lookup_view<json::ordered_value>)->Arg(16)->Arg(1024);
+BENCHMARK(object_lookup_hashed<json::value>)->Arg(16)->Arg(1024);
+BENCHMARK(object_lookup_hashed<json::ordered_value>)->Arg(16)->Arg(1024);
+BENCHMARK(object_fields_view)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(object_fields_key)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(object_sparse_throwing)->Arg(1 << 12)->Unit(benchmark::kMicrosecond);
+BENCHMARK(object_sparse_get_or)->Arg(1 << 12)->Unit(benchmark::kMicrosecond);
+BENCHMARK(object_iterate<json::value>)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK(object_iterate<json::ordered_value>)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK(object_construct<json::value>)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK(object_construct<json::ordered_value>)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK(object_parse_records<json::value>)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(object_parse_records<json::ordered_value>)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/parallel.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+void parse_single(benchmark::State& state) {
+    const auto s = json::bench::records_document(32 << 20);
+    for (auto _ : state) {
+        auto val = json::parse(s);
+        benchmark::DoNotOptimize(val);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * s.size()));
+}
+
+void parse_parallel(benchmark::State& state) {
+    const auto s = json::bench::records_document(32 << 20);
+    const auto options = json::parallel_options{.threads = std::size_t(state.range(0))};
+    for (auto _ : state) {
+        auto val = json::parse_parallel(s, options);
+        benchmark::DoNotOptimize(val);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * s.size()));
+}
+
+}
+
+BENCHMARK(parse_single)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(parse_parallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,235 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/document.hpp"
+#include "../include/meejson/file.hpp"
+#include "../include/meejson/push_parser.hpp"
+#include "alloc_counter.hpp"
+#include "data.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace json = mee::json;
+
+namespace {
+
+void report(benchmark::State& state, std::size_t input_size) {
+    const auto stats = json::bench::get_alloc_stats();
+    state.SetBytesProcessed(std::int64_t(state.iterations() * input_size));
+    state.counters["allocs"] = benchmark::Counter(double(stats.allocations), benchmark::Counter::kAvgIterations);
+    state.counters["peak_bytes"] = double(stats.peak_bytes - stats.current_bytes);
+}
+
+// The old pipeline: materialise the full token vector, then walk it
+void parse_two_pass(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto toks = json::lex(s);
+        auto val = json::parse(*toks);
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+void parse_fused(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::parse(s);
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+void parse_strings(benchmark::State& state) {
+    const auto s = json::bench::strings_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::parse(s);
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+void parse_numbers(benchmark::State& state) {
+    const auto s = json::bench::numbers_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::parse(s);
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+// Iterative and recursive engines over shallow records and deeply nested arrays
+void parse_shallow_iterative(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::parse(s);
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+void parse_shallow_recursive(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::detail::parse_recursive(s);
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+void parse_deep_iterative(benchmark::State& state) {
+    const auto depth = std::size_t(state.range(0));
+    const auto s = json::bench::nested_document(depth);
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::parse(s, {.max_depth = depth});
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+void parse_deep_recursive(benchmark::State& state) {
+    const auto depth = std::size_t(state.range(0));
+    const auto s = json::bench::nested_document(depth);
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::detail::parse_recursive(s, {.max_depth = depth});
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+// Parse and destroy, heap nodes against an arena
+void parse_value_destroy(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::parse(s);
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+void parse_document_destroy(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto doc = json::parse_document(s);
+        benchmark::DoNotOptimize(doc);
+    }
+    report(state, s.size());
+}
+
+// String heavy input into an arena, copying strings against viewing the text
+void parse_strings_document(benchmark::State& state) {
+    const auto s = json::bench::strings_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto doc = json::parse_document(s);
+        benchmark::DoNotOptimize(doc);
+    }
+    report(state, s.size());
+}
+
+void parse_strings_view_document(benchmark::State& state) {
+    const auto s = json::bench::strings_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto doc = json::parse_view_document(s);
+        benchmark::DoNotOptimize(doc);
+    }
+    report(state, s.size());
+}
+
+// 4 MB of records fed in pieces of the given size, as they would arrive from a socket
+void parse_push(benchmark::State& state) {
+    const auto s = json::bench::records_document(1 << 22);
+    const auto piece = std::size_t(state.range(0));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto parser = json::push_parser();
+        for (auto i = std::size_t(0); i < s.size(); i += piece) {
+            parser.feed(std::string_view(s).substr(i, piece));
+        }
+        auto val = parser.finish();
+        benchmark::DoNotOptimize(val);
+    }
+    report(state, s.size());
+}
+
+// Reading a file into a string first against parsing its mapping
+void parse_file_read(benchmark::State& state) {
+    const auto path = std::filesystem::temp_directory_path() / "meejson_bench_records.json";
+    std::ofstream(path) << json::bench::records_document(std::size_t(state.range(0)));
+    const auto size = std::filesystem::file_size(path);
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto in = std::ifstream(path, std::ios::binary);
+        auto s = std::string(size, '\0');
+        in.read(s.data(), std::streamsize(size));
+        auto doc = json::parse_document(s);
+        benchmark::DoNotOptimize(doc);
+    }
+    report(state, size);
+    std::filesystem::remove(path);
+}
+
+void parse_file_mapped(benchmark::State& state) {
+    const auto path = std::filesystem::temp_directory_path() / "meejson_bench_records.json";
+    std::ofstream(path) << json::bench::records_document(std::size_t(state.range(0)));
+    const auto size = std::filesystem::file_size(path);
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto doc = json::parse_document_file(path);
+        benchmark::DoNotOptimize(doc);
+    }
+    report(state, size);
+    std::filesystem::remove(path);
+}
+
+// Destruction alone
+template <class Parse>
+void destroy(benchmark::State& state, Parse parse) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto val = parse(s);
+        state.ResumeTiming();
+        { auto sink = std::move(*val); }
+    }
+}
+
+void destroy_value(benchmark::State& state) {
+    destroy(state, [](std::string_view s) { return json::parse(s); });
+}
+
+void destroy_document(benchmark::State& state) {
+    destroy(state, [](std::string_view s) { return json::parse_document(s); });
+}
+
+}
+
+BENCHMARK(parse_two_pass)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_fused)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_strings)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_numbers)->Arg(1 << 10)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_shallow_iterative)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_shallow_recursive)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_deep_iterative)->Arg(64)->Arg(1024)->Arg(8192)->Unit(benchmark::kMicrosecond);
+BENCHMARK(parse_deep_recursive)->Arg(64)->Arg(1024)->Arg(8192)->Unit(benchmark::kMicrosecond);
+BENCHMARK(parse_value_destroy)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_document_destroy)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_strings_document)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_strings_view_document)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_push)->Arg(1 << 6)->Arg(1 << 12)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_file_read)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_file_mapped)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(destroy_value)->Arg(1 << 16)->Arg(1 << 22)->Iterations(20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(destroy_document)->Arg(1 << 16)->Arg(1 << 22)->Iterations(20)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/projection.hpp"
+#include "../include/meejson/stream.hpp"
+#include "alloc_counter.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+// An event with `fields` members of mixed types, some of them nested
+auto event(std::size_t fields) -> std::string {
+    auto r = json::bench::rng();
+    auto s = std::string("{");
+    for (auto i = std::size_t(0); i < fields; i++) {
+        s += i ? ", " : "";
+        s += "\"field_" + std::to_string(i) + "\": ";
+        switch (i % 4) {
+            case 0:
+                s += std::to_string(r() % 1000000);
+                break;
+            case 1:
+                s += std::to_string(double(r() % 1000000) / 1000.0);
+                break;
+            case 2:
+                s += R"("a value with an \"escape\" in it )" + std::to_string(r() % 1000) + '"';
+                break;
+            default:
+                s += R"({"nested": [1, 2, 3], "flag": true})";
+                break;
+        }
+    }
+    return s + '}';
+}
+
+// Newline delimited events, as an ingest feed would arrive
+auto events() -> std::string {
+    const auto e = event(200);
+    auto s = std::string();
+    for (auto i = 0; i < 2000; i++) {
+        s += e + '\n';
+    }
+    return s;
+}
+
+void report(benchmark::State& state, std::size_t input_size) {
+    const auto stats = json::bench::get_alloc_stats();
+    state.SetBytesProcessed(std::int64_t(state.iterations() * input_size));
+    state.counters["allocs"] = benchmark::Counter(double(stats.allocations), benchmark::Counter::kAvgIterations);
+}
+
+void parse_events(benchmark::State& state, const json::parse_options& options) {
+    const auto s = events();
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto count = std::size_t(0);
+        json::parse_many(s, [&count](json::result<json::value>&& val) {
+            benchmark::DoNotOptimize(val);
+            count++;
+            return true;
+        }, {.parse = options, .threads = 1});
+        benchmark::DoNotOptimize(count);
+    }
+    report(state, s.size());
+}
+
+void events_full(benchmark::State& state) {
+    parse_events(state, {});
+}
+
+// Eight of the two hundred fields
+void events_projected(benchmark::State& state) {
+    const auto fields = json::projection{"/field_0", "/field_1", "/field_2", "/field_3", "/field_50", "/field_101", "/field_150", "/field_199"};
+    parse_events(state, {.fields = &fields});
+}
+
+}
+
+BENCHMARK(events_full)->Unit(benchmark::kMillisecond);
+BENCHMARK(events_projected)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/query.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+// An event of 20 sections with 10 fields each, some holding a small array
+auto event() -> json::value {
+    auto s = std::string("{");
+    for (auto i = 0; i < 20; i++) {
+        s += i ? ", " : "";
+        s += "\"section_" + std::to_string(i) + "\": {";
+        for (auto j = 0; j < 10; j++) {
+            s += j ? ", " : "";
+            s += "\"field_" + std::to_string(j) + "\": ";
+            s += j % 3 ? std::to_string(i * 10 + j) : "[1, 2, {\"x\": \"y\"}]";
+        }
+        s += '}';
+    }
+    return *json::parse(s + '}');
+}
+
+// 40 extraction rules, each two members deep
+auto rules() -> std::vector<std::pair<std::string, std::string>> {
+    auto r = std::vector<std::pair<std::string, std::string>>();
+    for (auto i = 0; i < 40; i++) {
+        r.emplace_back("section_" + std::to_string(i % 20), "field_" + std::to_string(i % 7));
+    }
+    return r;
+}
+
+void extract_chained(benchmark::State& state) {
+    const auto v = event();
+    const auto r = rules();
+    for (auto _ : state) {
+        for (const auto& [section, field] : r) {
+            const auto& match = v[section][field];
+            benchmark::DoNotOptimize(match);
+        }
+    }
+}
+
+void extract_queries(benchmark::State& state) {
+    const auto v = event();
+    auto queries = std::vector<json::query>();
+    for (const auto& [section, field] : rules()) {
+        queries.push_back(*json::compile_query("/" + section + "/" + field));
+    }
+    for (auto _ : state) {
+        for (const auto& q : queries) {
+            auto match = q.find_first(v);
+            benchmark::DoNotOptimize(match);
+        }
+    }
+}
+
+void extract_query_set(benchmark::State& state) {
+    const auto v = event();
+    auto queries = std::vector<json::query>();
+    for (const auto& [section, field] : rules()) {
+        queries.push_back(*json::compile_query("$." + section + "." + field));
+    }
+    const auto set = json::query_set(std::move(queries));
+    for (auto _ : state) {
+        set.for_each(v, [](std::size_t, const json::value& match) {
+            benchmark::DoNotOptimize(match);
+        });
+    }
+}
+
+// Filters, which need the members scanned rather than looked up
+void extract_query_set_scan(benchmark::State& state) {
+    const auto v = event();
+    auto queries = std::vector<json::query>();
+    for (auto i = 0; i < 40; i++) {
+        queries.push_back(*json::compile_query("$[?@.field_" + std::to_string(i % 10 / 3 * 3 + 1) + " > " + std::to_string(i * 5) + "].field_2"));
+    }
+    const auto set = json::query_set(std::move(queries));
+    for (auto _ : state) {
+        set.for_each(v, [](std::size_t, const json::value& match) {
+            benchmark::DoNotOptimize(match);
+        });
+    }
+}
+
+}
+
+BENCHMARK(extract_chained);
+BENCHMARK(extract_queries);
+BENCHMARK(extract_query_set);
+BENCHMARK(extract_query_set_scan);
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/sax.hpp"
+#include "alloc_counter.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+// Sums every "score" without building a tree
+struct score_sum {
+    double sum = 0;
+    bool in_score = false;
+
+    auto on_null() noexcept -> bool { return true; }
+    auto on_bool(bool) noexcept -> bool { return true; }
+    auto on_int(std::int64_t) noexcept -> bool { return true; }
+    auto on_string(std::string_view) noexcept -> bool { return true; }
+    auto start_object() noexcept -> bool { return true; }
+    auto end_object() noexcept -> bool { return true; }
+    auto start_array() noexcept -> bool { return true; }
+    auto end_array() noexcept -> bool { return true; }
+
+    auto on_key(std::string_view k) noexcept -> bool {
+        in_score = k == "score";
+        return true;
+    }
+
+    auto on_double(double d) noexcept -> bool {
+        if (in_score) {
+            sum += d;
+        }
+        return true;
+    }
+};
+
+void report(benchmark::State& state, std::size_t input_size) {
+    const auto stats = json::bench::get_alloc_stats();
+    state.SetBytesProcessed(std::int64_t(state.iterations() * input_size));
+    state.counters["allocs"] = benchmark::Counter(double(stats.allocations), benchmark::Counter::kAvgIterations);
+}
+
+void sum_sax(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto handler = score_sum();
+        auto err = json::parse_sax(s, handler);
+        benchmark::DoNotOptimize(err);
+        benchmark::DoNotOptimize(handler.sum);
+    }
+    report(state, s.size());
+}
+
+void sum_dom(benchmark::State& state) {
+    const auto s = json::bench::records_document(std::size_t(state.range(0)));
+    json::bench::reset_alloc_stats();
+    for (auto _ : state) {
+        auto val = json::parse(s);
+        auto sum = 0.0;
+        for (const auto& record : val->get_array()) {
+            sum += record["score"].get_float();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, s.size());
+}
+
+}
+
+BENCHMARK(sum_sax)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(sum_dom)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/serializer.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+template <class Document>
+void dump_into_buffer(benchmark::State& state, Document document) {
+    const auto val = *json::parse(document(std::size_t(state.range(0))));
+    auto out = std::string();
+    for (auto _ : state) {
+        out.clear();
+        json::dump(val, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * out.size()));
+}
+
+template <class Document>
+void dump_to_string(benchmark::State& state, Document document) {
+    const auto val = *json::parse(document(std::size_t(state.range(0))));
+    auto size = std::size_t(0);
+    for (auto _ : state) {
+        auto out = json::dump(val);
+        size = out.size();
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * size));
+}
+
+template <class Document>
+void dump_to_stream(benchmark::State& state, Document document) {
+    const auto val = *json::parse(document(std::size_t(state.range(0))));
+    auto size = std::size_t(0);
+    for (auto _ : state) {
+        auto os = std::ostringstream();
+        os << val;
+        size = os.view().size();
+        benchmark::DoNotOptimize(os);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * size));
+}
+
+void dump_records(benchmark::State& state) {
+    dump_into_buffer(state, json::bench::records_document);
+}
+
+void dump_strings(benchmark::State& state) {
+    dump_into_buffer(state, json::bench::strings_document);
+}
+
+void dump_numbers(benchmark::State& state) {
+    dump_into_buffer(state, json::bench::numbers_document);
+}
+
+void dump_records_string(benchmark::State& state) {
+    dump_to_string(state, json::bench::records_document);
+}
+
+void dump_records_stream(benchmark::State& state) {
+    dump_to_stream(state, json::bench::records_document);
+}
+
+void dump_strings_stream(benchmark::State& state) {
+    dump_to_stream(state, json::bench::strings_document);
+}
+
+void dump_numbers_stream(benchmark::State& state) {
+    dump_to_stream(state, json::bench::numbers_document);
+}
+
+}
+
+BENCHMARK(dump_records)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(dump_strings)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(dump_numbers)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK(dump_records_string)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(dump_records_stream)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(dump_strings_stream)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(dump_numbers_stream)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
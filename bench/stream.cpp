@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include "../include/meejson/stream.hpp"
+#include "data.hpp"
+
+namespace json = mee::json;
+
+namespace {
+
+// The records document with one record per line and no enclosing array
+auto ndjson_document(std::size_t bytes) -> std::string {
+    const auto records = json::bench::records_document(bytes);
+    auto s = std::string();
+    s.reserve(records.size());
+    for (auto i = std::size_t(1); i + 1 < records.size(); i++) {
+        if (records[i] != ',' || records[i + 1] != '\n') {
+            s += records[i];
+        }
+    }
+    return s + '\n';
+}
+
+void parse_lines(benchmark::State& state) {
+    const auto s = ndjson_document(32 << 20);
+    for (auto _ : state) {
+        auto count = std::size_t(0);
+        for (auto first = std::size_t(0); first < s.size();) {
+            const auto last = s.find('\n', first);
+            auto val = json::parse(std::string_view(s).substr(first, last - first));
+            benchmark::DoNotOptimize(val);
+            count++;
+            first = last + 1;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * s.size()));
+}
+
+void parse_many(benchmark::State& state) {
+    const auto s = ndjson_document(32 << 20);
+    const auto options = json::parse_many_options{.threads = std::size_t(state.range(0))};
+    for (auto _ : state) {
+        auto count = std::size_t(0);
+        json::parse_many(s, [&count](json::result<json::value>&& val) {
+            benchmark::DoNotOptimize(val);
+            count++;
+            return true;
+        }, options);
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations() * s.size()));
+}
+
+}
+
+BENCHMARK(parse_lines)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(parse_many)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -8,16 +8,21 @@
 #include <iostream>
 #include <ranges>
 
-#include "box.hpp"
+#include "detail.hpp"
+#include "serializer.hpp"
 
 namespace mee::json {
 
 namespace detail {
 
+// Elements are stored inline; the value boxes the array itself, which is enough to break the recursion
+template <class Value>
+using array_storage = std::vector<Value, value_allocator<Value>>;
+
 template <bool IsConst, class Value>
 struct array_iterator {
-    using base_type = typename std::vector<box<Value>>::iterator;
-    using const_base_type = typename std::vector<box<Value>>::const_iterator;
+    using base_type = typename array_storage<Value>::iterator;
+    using const_base_type = typename array_storage<Value>::const_iterator;
     using difference_type = std::conditional_t<IsConst, typename const_base_type::difference_type, typename base_type::difference_type>;
     using value_type = Value;
     using pointer = std::conditional_t<IsConst, const Value*, Value*>;
@@ -30,7 +35,7 @@ struct array_iterator {
     explicit array_iterator(const_base_type it) noexcept requires IsConst : m_iter(it) {}
 
     template <bool B> requires (IsConst || !B)
-    array_iterator(const array_iterator<B, Value>& it) noexcept : m_iter(it.m_iter) {}
+    array_iterator(const array_iterator<B, Value>& it) noexcept : m_iter(it.get_base()) {}
 
     auto operator==(const array_iterator& other) const noexcept -> bool = default;
 
@@ -39,15 +44,15 @@ struct array_iterator {
     }
 
     auto operator*() const noexcept -> reference {
-        return **m_iter;
+        return *m_iter;
     }
 
     auto operator->() const noexcept -> pointer {
-        return &**m_iter;
+        return std::addressof(*m_iter);
     }
 
     auto operator[](difference_type n) const noexcept -> reference {
-        return *m_iter[n];
+        return m_iter[n];
     }
 
     auto operator++() noexcept -> array_iterator& {
@@ -129,9 +134,9 @@ using const_array_iterator = detail::array_iterator<true, Value>;
 template <class Value>
 struct basic_array {
     using value_type = Value;
-    using allocator_type = std::allocator<Value>;
-    using size_type = typename std::vector<Value>::size_type;
-    using difference_type = typename std::vector<Value>::difference_type;
+    using allocator_type = detail::value_allocator<Value>;
+    using size_type = typename detail::array_storage<Value>::size_type;
+    using difference_type = typename detail::array_storage<Value>::difference_type;
     using reference = Value&;
     using const_reference = const Value&;
     using pointer = Value*;
@@ -145,7 +150,8 @@ struct basic_array {
     static_assert(std::random_access_iterator<const_iterator>);
 
     basic_array() = default;
-    basic_array(const basic_array& arr) : basic_array(arr.begin(), arr.end()) {}
+    explicit basic_array(const allocator_type& alloc) noexcept : m_arr(alloc) {}
+    basic_array(const basic_array& arr) : m_arr(arr.m_arr) {}
     basic_array(basic_array&&) noexcept = default;
 
     template <class Iter> requires std::input_iterator<Iter>
@@ -163,20 +169,14 @@ struct basic_array {
         }
     }
 
-    basic_array(size_type n, const Value& v) : m_arr(n) {
-        for (auto& ptr : m_arr) {
-            ptr = detail::make_box<Value>(v);
-        }
-    }
+    basic_array(size_type n, const Value& v) : m_arr(n, v) {}
 
     basic_array(std::initializer_list<Value> list) : basic_array(list.begin(), list.end()) {}
 
+    auto operator=(basic_array&&) noexcept -> basic_array& = default;
+
     auto operator=(const basic_array& arr) -> basic_array& {
-        resize(0);
-        reserve(arr.size());
-        for (const auto& val : arr.m_arr) {
-            push_back(*val);
-        }
+        m_arr = arr.m_arr;
         return *this;
     }
 
@@ -190,39 +190,39 @@ struct basic_array {
     }
 
     auto get_allocator() const -> allocator_type {
-        return allocator_type();
+        return allocator_type(m_arr.get_allocator());
     }
 
     auto at(size_type i) -> reference {
-        return *m_arr.at(i);
+        return m_arr.at(i);
     }
 
     auto at(size_type i) const -> const_reference {
-        return *m_arr.at(i);
+        return m_arr.at(i);
     }
 
     auto operator[](size_type i) noexcept -> reference {
-        return *m_arr[i];
+        return m_arr[i];
     }
 
     auto operator[](size_type i) const noexcept -> const_reference {
-        return *m_arr[i];
+        return m_arr[i];
     }
 
     auto front() noexcept -> reference {
-        return *m_arr.front();
+        return m_arr.front();
     }
 
     auto front() const noexcept -> const_reference {
-        return *m_arr.front();
+        return m_arr.front();
     }
 
     auto back() noexcept -> reference {
-        return *m_arr.back();
+        return m_arr.back();
     }
 
     auto back() const noexcept -> const_reference {
-        return *m_arr.back();
+        return m_arr.back();
     }
 
     auto begin() noexcept -> iterator {
@@ -290,7 +290,7 @@ struct basic_array {
     }
 
     auto capacity() const noexcept -> size_type {
-        return m_arr.size();
+        return m_arr.capacity();
     }
 
     void shrink_to_fit() {
@@ -302,11 +302,11 @@ struct basic_array {
     }
 
     auto insert(const_iterator it, const Value& v) -> iterator {
-        return iterator(m_arr.insert(it.get_base(), detail::make_box<Value>(v)));
+        return iterator(m_arr.insert(it.get_base(), v));
     }
 
     auto insert(const_iterator it, Value&& v) -> iterator {
-        return iterator(m_arr.insert(it.get_base(), detail::make_box<Value>(std::move(v))));
+        return iterator(m_arr.insert(it.get_base(), std::move(v)));
     }
 
     auto erase(const_iterator it) -> iterator {
@@ -314,11 +314,11 @@ struct basic_array {
     }
 
     void push_back(const Value& v) {
-        m_arr.push_back(detail::make_box<Value>(v));
+        m_arr.push_back(v);
     }
 
     void push_back(Value&& v) {
-        m_arr.push_back(detail::make_box<Value>(std::move(v)));
+        m_arr.push_back(std::move(v));
     }
 
     void pop_back() {
@@ -326,29 +326,21 @@ struct basic_array {
     }
 
     void resize(size_type n) {
-        auto old_size = size();
         m_arr.resize(n);
-        for (auto i = old_size; i < n; i++) {
-            m_arr[i] = detail::make_box<Value>();
-        }
     }
 
     void resize(size_type n, const Value& v) {
-        auto old_size = size();
-        m_arr.resize(n);
-        for (auto i = old_size; i < n; i++) {
-            m_arr[i] = detail::make_box<Value>(v);
-        }
+        m_arr.resize(n, v);
     }
 
     template <class T> requires std::is_constructible_v<Value, std::remove_reference_t<T>>
     auto emplace(const_iterator pos, T&& arg) -> iterator {
-        return m_arr.emplace(pos, std::forward<T>(arg));
+        return iterator(m_arr.emplace(pos.get_base(), std::forward<T>(arg)));
     }
 
     template <class T> requires std::is_constructible_v<Value, std::remove_reference_t<T>>
     auto emplace_back(T&& arg) -> reference {
-        return *m_arr.emplace_back(detail::make_box<Value>(std::forward<T>(arg)));
+        return m_arr.emplace_back(std::forward<T>(arg));
     }
 
     template <class V>
@@ -363,27 +355,19 @@ struct basic_array {
     }
 
 private:
-    std::vector<detail::box<Value>> m_arr;
+    detail::array_storage<Value> m_arr;
 };
 
 template <class V>
 void swap(basic_array<V>& lhs, basic_array<V>& rhs) noexcept {
-    std::swap_ranges(lhs.begin(), rhs.end(), rhs.begin());
+    lhs.m_arr.swap(rhs.m_arr);
 }
 
 template <class V>
 auto operator<<(std::ostream& os, const basic_array<V>& arr) noexcept -> std::ostream& {
-    os << '[';
-    auto iter = arr.begin();
-    if (iter != arr.end()) {
-        std::cout << *iter;
-        iter++;
-        for (; iter != arr.end(); iter++) {
-            std::cout << ',' << *iter;
-        }
-    }
-    os << ']';
-    return os;
+    auto out = std::string();
+    detail::dump_array(arr, out);
+    return os << out;
 }
 }
 
@@ -6,19 +6,42 @@
 
 namespace mee::json::detail {
 
-template <class T>
+template <class T, class Alloc = std::allocator<T>>
+struct box;
+
+template <class T, class Alloc, class... Args>
+auto allocate_box(const Alloc& alloc, Args&&... args) -> box<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
+template <class T, class... Args>
+auto make_box(Args&&... args) -> box<T>;
+
+// Owning pointer to a T allocated from Alloc. Stateless allocators take no space. The T is
+// constructed as given rather than handed the allocator, so it keeps whichever allocator it was built with.
+template <class T, class Alloc>
 struct box {
+    using traits = std::allocator_traits<Alloc>;
+
     constexpr box(std::nullptr_t = nullptr) noexcept {}
     box(const box&) = delete;
-    box(box&&) noexcept = default;
-
-    template <class U>
-    box(box<U>&& b) : m_ptr(std::move(b)) {}
+    box(box&& other) noexcept : m_ptr(std::exchange(other.m_ptr, nullptr)), m_alloc(other.m_alloc) {}
 
     auto operator=(const box&) -> box& = delete;
-    auto operator=(box&&) noexcept -> box& = default;
 
-    ~box() noexcept = default;
+    // Allocators such as std::pmr::polymorphic_allocator can't be assigned, so the box is rebuilt
+    auto operator=(box&& other) noexcept -> box& {
+        if (this != &other) {
+            std::destroy_at(this);
+            std::construct_at(this, std::move(other));
+        }
+        return *this;
+    }
+
+    ~box() noexcept {
+        if (m_ptr) {
+            std::destroy_at(m_ptr);
+            traits::deallocate(m_alloc, m_ptr, 1);
+        }
+    }
 
     auto operator*() noexcept -> T& {
         return *m_ptr;
@@ -29,34 +52,52 @@ struct box {
     }
 
     auto operator->() noexcept -> T* {
-        return std::addressof(*m_ptr);
+        return m_ptr;
     }
 
     auto operator->() const noexcept -> const T* {
-        return std::addressof(*m_ptr);
+        return m_ptr;
     }
 
     explicit operator bool() const noexcept {
-        return bool(m_ptr);
+        return m_ptr != nullptr;
     }
 
+    // Copies follow the allocator's copy construction rules, as a container's would
     auto clone() const -> box {
-        return make_box<T>(*m_ptr);
+        return allocate_box<T>(traits::select_on_container_copy_construction(m_alloc), *m_ptr);
     }
 
-    template <class U, class... Args>
-    friend auto make_box(Args&&... args) -> box<U>;
+    template <class U, class A, class... Args>
+    friend auto allocate_box(const A& alloc, Args&&... args) -> box<U, typename std::allocator_traits<A>::template rebind_alloc<U>>;
 private:
-    std::unique_ptr<T> m_ptr;
+    explicit box(const Alloc& alloc) noexcept : m_alloc(alloc) {}
+
+    T* m_ptr = nullptr;
+    [[no_unique_address]] Alloc m_alloc;
 };
 
+template <class T, class Alloc, class... Args>
+auto allocate_box(const Alloc& alloc, Args&&... args) -> box<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>> {
+    using allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+    using traits = std::allocator_traits<allocator>;
+    auto b = box<T, allocator>(allocator(alloc));
+    auto p = traits::allocate(b.m_alloc, 1);
+    try {
+        std::construct_at(p, std::forward<Args>(args)...);
+    } catch (...) {
+        traits::deallocate(b.m_alloc, p, 1);
+        throw;
+    }
+    b.m_ptr = p;
+    return b;
+}
+
 template <class T, class... Args>
 auto make_box(Args&&... args) -> box<T> {
-    auto b = box<T>();
-    b.m_ptr = std::make_unique<T>(std::forward<Args>(args)...);
-    return b;
+    return allocate_box<T>(std::allocator<T>(), std::forward<Args>(args)...);
 }
 
 }
 
-#endif
\ No newline at end of file
+#endif
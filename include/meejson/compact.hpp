@@ -0,0 +1,173 @@
+#ifndef JSON_COMPACT_HPP
+#define JSON_COMPACT_HPP
+
+#include <bit>
+#include <compare>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "value.hpp"
+
+namespace mee::json {
+
+namespace compact {
+
+// A string in a single pointer sized word. Up to seven bytes are stored inline, with the low bit
+// of the word set as a tag; longer strings live in a heap block prefixed with their length, whose
+// alignment keeps that bit clear. The length is fixed at construction.
+struct string {
+    using value_type = char;
+    using size_type = std::size_t;
+    using const_iterator = const char*;
+
+    constexpr static auto inline_capacity = sizeof(void*) - 1;
+
+    string() noexcept {
+        set_inline(0);
+    }
+
+    string(const char* s) : string(std::string_view(s)) {}
+
+    explicit string(std::string_view s) {
+        if (s.size() <= inline_capacity) {
+            set_inline(s.size());
+            std::memcpy(inline_data(), s.data(), s.size());
+        } else {
+            auto block = allocator().allocate(words(s.size()));
+            block[0] = s.size();
+            std::memcpy(block + 1, s.data(), s.size());
+            std::memcpy(m_word, &block, sizeof(block));
+        }
+    }
+
+    string(const string& other) : string(std::string_view(other)) {}
+
+    string(string&& other) noexcept {
+        std::memcpy(m_word, other.m_word, sizeof(m_word));
+        other.set_inline(0);
+    }
+
+    auto operator=(const string& other) -> string& {
+        if (this != &other) {
+            *this = string(other);
+        }
+        return *this;
+    }
+
+    auto operator=(string&& other) noexcept -> string& {
+        if (this != &other) {
+            release();
+            std::memcpy(m_word, other.m_word, sizeof(m_word));
+            other.set_inline(0);
+        }
+        return *this;
+    }
+
+    ~string() {
+        release();
+    }
+
+    [[nodiscard]] auto data() const noexcept -> const char* {
+        return is_inline() ? inline_data() : reinterpret_cast<const char*>(block() + 1);
+    }
+
+    [[nodiscard]] auto size() const noexcept -> size_type {
+        return is_inline() ? size_type(tag_byte() >> 1) : block()[0];
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return size() == 0;
+    }
+
+    [[nodiscard]] auto begin() const noexcept -> const_iterator {
+        return data();
+    }
+
+    [[nodiscard]] auto end() const noexcept -> const_iterator {
+        return data() + size();
+    }
+
+    operator std::string_view() const noexcept {
+        return {data(), size()};
+    }
+
+    friend auto operator==(const string& lhs, const string& rhs) noexcept -> bool {
+        return std::string_view(lhs) == std::string_view(rhs);
+    }
+
+    friend auto operator<=>(const string& lhs, const string& rhs) noexcept -> std::strong_ordering {
+        return std::string_view(lhs) <=> std::string_view(rhs);
+    }
+
+    friend auto operator<<(std::ostream& os, const string& s) -> std::ostream& {
+        return os << std::string_view(s);
+    }
+
+private:
+    using allocator = std::allocator<std::size_t>;
+
+    // The tag lives in the least significant byte of the word, wherever the platform puts it
+    constexpr static auto tag_index = std::endian::native == std::endian::little ? 0 : sizeof(void*) - 1;
+    constexpr static auto data_index = std::endian::native == std::endian::little ? 1 : 0;
+
+    static auto words(size_type n) noexcept -> size_type {
+        return 1 + (n + sizeof(std::size_t) - 1) / sizeof(std::size_t);
+    }
+
+    [[nodiscard]] auto tag_byte() const noexcept -> unsigned char {
+        return m_word[tag_index];
+    }
+
+    [[nodiscard]] auto is_inline() const noexcept -> bool {
+        return tag_byte() & 1;
+    }
+
+    void set_inline(size_type n) noexcept {
+        m_word[tag_index] = static_cast<unsigned char>((n << 1) | 1);
+    }
+
+    auto inline_data() noexcept -> char* {
+        return reinterpret_cast<char*>(m_word + data_index);
+    }
+
+    [[nodiscard]] auto inline_data() const noexcept -> const char* {
+        return reinterpret_cast<const char*>(m_word + data_index);
+    }
+
+    [[nodiscard]] auto block() const noexcept -> std::size_t* {
+        auto p = static_cast<std::size_t*>(nullptr);
+        std::memcpy(&p, m_word, sizeof(p));
+        return p;
+    }
+
+    void release() noexcept {
+        if (!is_inline()) {
+            auto p = block();
+            allocator().deallocate(p, words(p[0]));
+        }
+    }
+
+    alignas(void*) unsigned char m_word[sizeof(void*)]{};
+};
+
+// Every alternative is at most a word, so the variant is a word plus its index
+using value = basic_value<std::int64_t, double, string>;
+using array = basic_array<value>;
+using object = basic_object<value>;
+
+}
+
+}
+
+template <>
+struct std::hash<mee::json::compact::string> {
+    auto operator()(const mee::json::compact::string& s) const noexcept -> std::size_t {
+        return std::hash<std::string_view>()(s);
+    }
+};
+
+#endif
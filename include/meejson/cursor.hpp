@@ -0,0 +1,262 @@
+#ifndef JSON_CURSOR_HPP
+#define JSON_CURSOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "lexer.hpp"
+
+namespace mee::json {
+
+struct cursor;
+struct cursor_array;
+struct cursor_object;
+
+// A value in the text a cursor reads, known only by where it starts. Nothing is read until an
+// accessor is called, and nothing is ever allocated: values being looked past are stepped over by
+// matching brackets, numbers and literals are converted in place and strings without escapes are
+// viewed in the text. Accessors mirror basic_value's, throwing invalid_operation for the wrong type,
+// invalid_access for a missing member and error_exception for malformed input.
+struct cursor_value {
+    [[nodiscard]] auto type_name() const -> std::string_view;
+
+    [[nodiscard]] auto is_null() const -> bool;
+
+    [[nodiscard]] auto get_bool() const -> bool;
+    [[nodiscard]] auto get_int() const -> std::int64_t;
+    [[nodiscard]] auto get_float() const -> double;
+    // Strings with escapes are decoded into the cursor, and stay valid until the next one is read
+    [[nodiscard]] auto get_string() const -> std::string_view;
+    [[nodiscard]] auto get_array() const -> cursor_array;
+    [[nodiscard]] auto get_object() const -> cursor_object;
+
+    [[nodiscard]] auto get_if_bool() const -> std::optional<bool>;
+    [[nodiscard]] auto get_if_int() const -> std::optional<std::int64_t>;
+    [[nodiscard]] auto get_if_float() const -> std::optional<double>;
+    [[nodiscard]] auto get_if_string() const -> std::optional<std::string_view>;
+    [[nodiscard]] auto get_if_array() const -> std::optional<cursor_array>;
+    [[nodiscard]] auto get_if_object() const -> std::optional<cursor_object>;
+
+    [[nodiscard]] auto has_key(std::string_view k) const -> bool;
+    // Looks for the member after the one this value last found, wrapping round to the start of the
+    // object, so fields read in the order they are written are each found with a single pass
+    auto operator[](std::string_view k) const -> cursor_value;
+    auto operator[](std::size_t i) const -> cursor_value;
+
+    // The text of the value, as it appears in the input
+    [[nodiscard]] auto source() const -> std::string_view;
+
+private:
+    friend struct cursor;
+    friend struct cursor_array;
+    friend struct cursor_member;
+    friend struct cursor_object;
+
+    cursor_value(cursor* c, std::size_t offset) noexcept : m_cursor(c), m_offset(offset) {}
+
+    [[nodiscard]] auto first() const noexcept -> char;
+
+    cursor* m_cursor;
+    std::size_t m_offset;
+    // Where the value of the member last found by operator[] starts, or 0 before the first lookup
+    mutable std::size_t m_found = 0;
+};
+
+struct cursor_array {
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = cursor_value;
+        using difference_type = std::ptrdiff_t;
+        using reference = cursor_value;
+
+        iterator() noexcept = default;
+
+        auto operator*() const noexcept -> cursor_value {
+            return cursor_value(m_cursor, m_offset);
+        }
+
+        // Steps over the current element, whether or not it was read
+        auto operator++() -> iterator&;
+
+        auto operator++(int) -> iterator {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        auto operator==(const iterator&) const noexcept -> bool = default;
+
+    private:
+        friend struct cursor_array;
+
+        iterator(cursor* c, std::size_t offset) noexcept : m_cursor(c), m_offset(offset) {}
+
+        cursor* m_cursor = nullptr;
+        std::size_t m_offset = std::numeric_limits<std::size_t>::max();
+    };
+
+    [[nodiscard]] auto begin() const -> iterator;
+    [[nodiscard]] auto end() const noexcept -> iterator;
+
+    [[nodiscard]] auto empty() const -> bool;
+    // Counts the elements, stepping over each one
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    auto operator[](std::size_t i) const -> cursor_value;
+
+private:
+    friend struct cursor_value;
+
+    cursor_array(cursor* c, std::size_t offset) noexcept : m_cursor(c), m_offset(offset) {}
+
+    cursor* m_cursor;
+    std::size_t m_offset;
+};
+
+// A member of a cursor_object. first() and second() match basic_object's members.
+struct cursor_member {
+    // Keys with escapes are decoded apart from string values, so a key stays valid while its
+    // value is read
+    [[nodiscard]] auto first() const -> std::string_view;
+    [[nodiscard]] auto second() const -> cursor_value;
+
+private:
+    friend struct cursor_object;
+
+    cursor_member(cursor* c, std::size_t offset) noexcept : m_cursor(c), m_offset(offset) {}
+
+    cursor* m_cursor;
+    // Where the key starts
+    std::size_t m_offset;
+};
+
+struct cursor_object {
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = cursor_member;
+        using difference_type = std::ptrdiff_t;
+        using reference = cursor_member;
+
+        iterator() noexcept = default;
+
+        auto operator*() const noexcept -> cursor_member {
+            return cursor_member(m_cursor, m_offset);
+        }
+
+        auto operator++() -> iterator&;
+
+        auto operator++(int) -> iterator {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        auto operator==(const iterator&) const noexcept -> bool = default;
+
+    private:
+        friend struct cursor_object;
+
+        iterator(cursor* c, std::size_t offset) noexcept : m_cursor(c), m_offset(offset) {}
+
+        cursor* m_cursor = nullptr;
+        std::size_t m_offset = std::numeric_limits<std::size_t>::max();
+    };
+
+    [[nodiscard]] auto begin() const -> iterator;
+    [[nodiscard]] auto end() const noexcept -> iterator;
+
+    [[nodiscard]] auto empty() const -> bool;
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    // Members are searched in order, stepping over the values of those that don't match
+    [[nodiscard]] auto find(std::string_view k) const -> iterator;
+    [[nodiscard]] auto contains(std::string_view k) const -> bool;
+    [[nodiscard]] auto at(std::string_view k) const -> cursor_value;
+
+    auto operator[](std::string_view k) const -> cursor_value {
+        return at(k);
+    }
+
+private:
+    friend struct cursor_value;
+
+    cursor_object(cursor* c, std::size_t offset) noexcept : m_cursor(c), m_offset(offset) {}
+
+    cursor* m_cursor;
+    std::size_t m_offset;
+};
+
+// Reads values straight out of the text, without parsing it first: there is no tree and no
+// structural index, and only the parts of the input between the start and the values asked for
+// are looked at. Only what is read is checked; text that is stepped over just needs its brackets
+// and quotes to match, and nothing after the root value is looked at. Reading in document order
+// is cheapest, since each lookup carries on from the last. The text must outlive the cursor, and
+// values point at the cursor, so it can be neither copied nor moved. A cursor keeps the lexer it
+// reports errors with and the buffers strings are decoded into, so it must not be read from
+// several threads at once.
+struct cursor {
+    explicit cursor(std::string_view text) noexcept;
+
+    cursor(const cursor&) = delete;
+    auto operator=(const cursor&) -> cursor& = delete;
+
+    [[nodiscard]] auto root() -> cursor_value;
+
+    auto operator*() -> cursor_value {
+        return root();
+    }
+
+    // Looks up members of the root object, carrying on from the last member found
+    auto operator[](std::string_view k) -> cursor_value;
+
+private:
+    friend struct cursor_value;
+    friend struct cursor_array;
+    friend struct cursor_member;
+    friend struct cursor_object;
+
+    static constexpr auto npos = std::numeric_limits<std::size_t>::max();
+
+    [[nodiscard]] auto at(std::size_t offset) const noexcept -> char {
+        return m_text[offset];
+    }
+
+    // Offset of the first character at or after `offset` that isn't whitespace. Reaching the end of
+    // the text is an error described by `msg`.
+    auto skip_whitespace(std::size_t offset, std::string_view msg) -> std::size_t;
+    // Offset just past the value starting at `offset`
+    auto skip(std::size_t offset) -> std::size_t;
+    auto skip_string(std::size_t offset) -> std::size_t;
+
+    // First element of the array opening at `offset`, or npos if it is empty
+    auto first_element(std::size_t offset) -> std::size_t;
+    // The element after the one starting at `offset`, or npos after the last
+    auto next_element(std::size_t offset) -> std::size_t;
+    // First key of the object opening at `offset`, or npos if it is empty
+    auto first_key(std::size_t offset) -> std::size_t;
+    // The key after the member whose value starts at `offset`, or npos after the last
+    auto next_key(std::size_t value) -> std::size_t;
+    // Where the value of the member whose key starts at `offset` starts
+    auto member_value(std::size_t key) -> std::size_t;
+
+    auto scalar_at(std::size_t offset) -> detail::scalar;
+    auto string_at(std::size_t offset, std::string& scratch) -> std::string_view;
+
+    [[noreturn]] void unexpected(std::size_t offset, std::string_view prefix, std::string_view suffix);
+    [[noreturn]] void fail(std::size_t offset, std::string_view msg);
+
+    std::string_view m_text;
+    detail::lexer m_lexer;
+    cursor_value m_root;
+    std::string m_scratch;
+    std::string m_key_scratch;
+};
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef JSON_DETAIL_HPP
 #define JSON_DETAIL_HPP
 
+#include <memory>
 #include <type_traits>
 
 namespace mee::json::detail {
@@ -12,6 +13,13 @@ struct overload : Ts... {
 
 template <class... Ts>
 overload(Ts...) -> overload<Ts...>;
+
+template <class Alloc, class T>
+using rebind_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+// The allocator a value's containers use for their elements
+template <class Value>
+using value_allocator = rebind_alloc<typename Value::allocator_type, Value>;
 }
 
 #endif
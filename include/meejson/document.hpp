@@ -0,0 +1,80 @@
+#ifndef JSON_DOCUMENT_HPP
+#define JSON_DOCUMENT_HPP
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+#include "value.hpp"
+#include "parser.hpp"
+
+namespace mee::json {
+
+namespace pmr {
+// Values whose strings, boxes and container storage all come from a std::pmr::memory_resource
+using value = basic_value<std::int64_t, double, std::pmr::string, basic_array, basic_object, std::pmr::polymorphic_allocator<>>;
+using array = basic_array<value>;
+using object = basic_object<value>;
+}
+
+namespace view {
+// Values whose strings are views. Strings without escapes point straight into the parsed text;
+// everything else comes from the document's arena.
+using value = basic_value<std::int64_t, double, std::string_view, basic_array, basic_object, std::pmr::polymorphic_allocator<>>;
+using array = basic_array<value>;
+using object = basic_object<value>;
+}
+
+template <class Value>
+struct basic_document;
+
+namespace detail {
+// Parses `s` into a fresh arena. `source` is kept alive for as long as the document.
+template <class Value>
+auto parse_arena(std::string_view s, std::shared_ptr<const void> source, const parse_options& options) noexcept -> result<basic_document<Value>>;
+}
+
+// A parsed value that lives entirely in an arena owned by the document. The tree is read only, so
+// nothing outside the arena can end up in it, and destroying the document releases the arena in a
+// few frees without visiting a single node. A document of views may also hold on to the text its
+// strings point into.
+template <class Value>
+struct basic_document {
+    basic_document(basic_document&&) noexcept = default;
+    auto operator=(basic_document&&) noexcept -> basic_document& = default;
+    ~basic_document() = default;
+
+    [[nodiscard]] auto root() const noexcept -> const Value& {
+        return *m_root;
+    }
+
+    auto operator*() const noexcept -> const Value& {
+        return *m_root;
+    }
+
+    auto operator->() const noexcept -> const Value* {
+        return m_root;
+    }
+
+    template <class V>
+    friend auto detail::parse_arena(std::string_view, std::shared_ptr<const void>, const parse_options&) noexcept -> result<basic_document<V>>;
+private:
+    basic_document(std::shared_ptr<const void> source, std::unique_ptr<std::pmr::monotonic_buffer_resource> arena, Value* root) noexcept
+    : m_source(std::move(source)), m_arena(std::move(arena)), m_root(root) {}
+
+    std::shared_ptr<const void> m_source;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena;
+    Value* m_root;
+};
+
+using document = basic_document<pmr::value>;
+using view_document = basic_document<view::value>;
+
+auto parse_document(std::string_view, const parse_options& = {}) noexcept -> result<document>;
+
+// Strings without escapes are not copied, so `s` must outlive the document
+auto parse_view_document(std::string_view s, const parse_options& = {}) noexcept -> result<view_document>;
+
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include <string>
 #include <variant>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include "type_list.hpp"
 
@@ -50,20 +52,26 @@ struct error_exception : std::exception {
 template <class T>
 struct result {
     explicit(false) result(const T& val) : m_var(val) {}
+    explicit(false) result(T&& val) noexcept(std::is_nothrow_move_constructible_v<T>) : m_var(std::move(val)) {}
     explicit(false) result(const error& err) : m_var(err) {}
+    explicit(false) result(json::error&& err) noexcept : m_var(std::move(err)) {}
 
     explicit operator bool() const noexcept {
         return std::holds_alternative<T>(m_var);
     }
 
-    auto operator*() -> T& {
+    auto operator*() & -> T& {
         return std::get<T>(m_var);
     }
 
-    auto operator*() const -> const T& {
+    auto operator*() const& -> const T& {
         return std::get<T>(m_var);
     }
 
+    auto operator*() && -> T&& {
+        return std::get<T>(std::move(m_var));
+    }
+
     auto operator->() -> T* {
         return &std::get<T>(m_var);
     }
@@ -72,14 +80,18 @@ struct result {
         return &std::get<T>(m_var);
     }
 
-    auto error() -> json::error& {
+    auto error() & -> json::error& {
         return std::get<json::error>(m_var);
     }
 
-    [[nodiscard]] auto error() const -> const json::error& {
+    [[nodiscard]] auto error() const& -> const json::error& {
         return std::get<json::error>(m_var);
     }
 
+    auto error() && -> json::error&& {
+        return std::get<json::error>(std::move(m_var));
+    }
+
     template <class F> requires visitable<F, type_list<T, json::error>>
     auto visit(F&& f) const {
         return std::visit(std::forward<F>(f), m_var);
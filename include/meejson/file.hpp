@@ -0,0 +1,57 @@
+#ifndef JSON_FILE_HPP
+#define JSON_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "document.hpp"
+#include "parser.hpp"
+
+namespace mee::json {
+
+// The contents of a file, mapped read only where the platform supports it and read into memory
+// otherwise. Mapped pages are backed by the page cache, so holding a large file costs no heap
+// copy of it. The parser never reads past the end of its input, so no padding is needed.
+struct mapped_file {
+    mapped_file(mapped_file&& other) noexcept;
+    auto operator=(mapped_file&& other) noexcept -> mapped_file&;
+    ~mapped_file();
+
+    [[nodiscard]] auto data() const noexcept -> const char* {
+        return m_data;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_size;
+    }
+
+    operator std::string_view() const noexcept {
+        return {m_data, m_size};
+    }
+
+    friend auto map_file(const std::filesystem::path&) noexcept -> result<mapped_file>;
+private:
+    mapped_file() noexcept = default;
+
+    void release() noexcept;
+
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_mapped = false;
+    std::string m_buffer;
+};
+
+// Errors opening or reading the file are reported at line 0, column 0
+auto map_file(const std::filesystem::path&) noexcept -> result<mapped_file>;
+
+auto parse_file(const std::filesystem::path&, const parse_options& = {}) noexcept -> result<value>;
+auto parse_document_file(const std::filesystem::path&, const parse_options& = {}) noexcept -> result<document>;
+
+// The document keeps the file mapped, and its strings point into the mapping wherever they can
+auto parse_view_document_file(const std::filesystem::path&, const parse_options& = {}) noexcept -> result<view_document>;
+
+}
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef JSON_LAZY_HPP
+#define JSON_LAZY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "parser.hpp"
+
+namespace mee::json {
+
+struct lazy_document;
+struct lazy_array;
+struct lazy_object;
+
+// A value in a lazy_document that hasn't been read yet. It is two words, and finding one never
+// allocates: aggregates are stepped over using the bracket positions recorded when the document
+// was parsed, and scalars are only lexed when asked for. Accessors mirror basic_value's, throwing
+// invalid_operation for the wrong type and invalid_access for a missing member.
+struct lazy_value {
+    [[nodiscard]] auto type_name() const -> std::string_view;
+
+    [[nodiscard]] auto is_null() const -> bool;
+
+    [[nodiscard]] auto get_bool() const -> bool;
+    [[nodiscard]] auto get_int() const -> std::int64_t;
+    [[nodiscard]] auto get_float() const -> double;
+    // Strings without escapes are viewed in the document's text; others are decoded once and kept
+    // by the document
+    [[nodiscard]] auto get_string() const -> std::string_view;
+    [[nodiscard]] auto get_array() const -> lazy_array;
+    [[nodiscard]] auto get_object() const -> lazy_object;
+
+    [[nodiscard]] auto get_if_bool() const -> std::optional<bool>;
+    [[nodiscard]] auto get_if_int() const -> std::optional<std::int64_t>;
+    [[nodiscard]] auto get_if_float() const -> std::optional<double>;
+    [[nodiscard]] auto get_if_string() const -> std::optional<std::string_view>;
+    [[nodiscard]] auto get_if_array() const -> std::optional<lazy_array>;
+    [[nodiscard]] auto get_if_object() const -> std::optional<lazy_object>;
+
+    [[nodiscard]] auto has_key(std::string_view k) const -> bool;
+    auto operator[](std::string_view k) const -> lazy_value;
+    auto operator[](std::size_t i) const -> lazy_value;
+
+    // The text of the value, as it appears in the document
+    [[nodiscard]] auto source() const -> std::string_view;
+
+    // Reads the whole value, everything inside it included
+    [[nodiscard]] auto to_value() const -> value;
+
+private:
+    friend struct lazy_document;
+    friend struct lazy_array;
+    friend struct lazy_member;
+    friend struct lazy_object;
+
+    lazy_value(const lazy_document* doc, std::uint32_t pos) noexcept : m_doc(doc), m_pos(pos) {}
+
+    const lazy_document* m_doc;
+    // Position of the value's first byte in the structural index
+    std::uint32_t m_pos;
+};
+
+struct lazy_array {
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = lazy_value;
+        using difference_type = std::ptrdiff_t;
+        using reference = lazy_value;
+
+        iterator() noexcept = default;
+
+        auto operator*() const noexcept -> lazy_value {
+            return lazy_value(m_doc, m_pos);
+        }
+
+        auto operator++() -> iterator&;
+
+        auto operator++(int) -> iterator {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        auto operator==(const iterator&) const noexcept -> bool = default;
+
+    private:
+        friend struct lazy_array;
+
+        iterator(const lazy_document* doc, std::uint32_t pos) noexcept : m_doc(doc), m_pos(pos) {}
+
+        const lazy_document* m_doc = nullptr;
+        std::uint32_t m_pos = 0;
+    };
+
+    [[nodiscard]] auto begin() const -> iterator;
+    [[nodiscard]] auto end() const -> iterator;
+
+    [[nodiscard]] auto empty() const -> bool;
+    // Counts the elements, stepping over each one
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    auto operator[](std::size_t i) const -> lazy_value;
+
+private:
+    friend struct lazy_value;
+
+    lazy_array(const lazy_document* doc, std::uint32_t pos) noexcept : m_doc(doc), m_pos(pos) {}
+
+    const lazy_document* m_doc;
+    std::uint32_t m_pos;
+};
+
+// A member of a lazy_object. first() and second() match basic_object's members.
+struct lazy_member {
+    [[nodiscard]] auto first() const -> std::string_view;
+
+    [[nodiscard]] auto second() const noexcept -> lazy_value {
+        return lazy_value(m_doc, m_pos + 2);
+    }
+
+private:
+    friend struct lazy_object;
+
+    lazy_member(const lazy_document* doc, std::uint32_t pos) noexcept : m_doc(doc), m_pos(pos) {}
+
+    const lazy_document* m_doc;
+    // Position of the key; the colon and then the value follow it in the index
+    std::uint32_t m_pos;
+};
+
+struct lazy_object {
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = lazy_member;
+        using difference_type = std::ptrdiff_t;
+        using reference = lazy_member;
+
+        iterator() noexcept = default;
+
+        auto operator*() const noexcept -> lazy_member {
+            return lazy_member(m_doc, m_pos);
+        }
+
+        auto operator++() -> iterator&;
+
+        auto operator++(int) -> iterator {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        auto operator==(const iterator&) const noexcept -> bool = default;
+
+    private:
+        friend struct lazy_object;
+
+        iterator(const lazy_document* doc, std::uint32_t pos) noexcept : m_doc(doc), m_pos(pos) {}
+
+        const lazy_document* m_doc = nullptr;
+        std::uint32_t m_pos = 0;
+    };
+
+    [[nodiscard]] auto begin() const -> iterator;
+    [[nodiscard]] auto end() const -> iterator;
+
+    [[nodiscard]] auto empty() const -> bool;
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    // Members are searched in order, skipping the values of those that don't match
+    [[nodiscard]] auto find(std::string_view k) const -> iterator;
+    [[nodiscard]] auto contains(std::string_view k) const -> bool;
+    [[nodiscard]] auto at(std::string_view k) const -> lazy_value;
+
+    auto operator[](std::string_view k) const -> lazy_value {
+        return at(k);
+    }
+
+private:
+    friend struct lazy_value;
+
+    lazy_object(const lazy_document* doc, std::uint32_t pos) noexcept : m_doc(doc), m_pos(pos) {}
+
+    const lazy_document* m_doc;
+    std::uint32_t m_pos;
+};
+
+// A parsed document of which only the structure has been read. Parsing indexes the structural
+// characters and checks that they are well formed, recording where each array and object ends;
+// scalars are lexed only when accessed, so errors inside an untouched number or string go
+// unnoticed and a bad one is reported by throwing error_exception when read. The text must
+// outlive the document, and values point at the document, so take them once it has been moved
+// into place. Decoded strings are cached, so a document must not be read from several threads at
+// once.
+struct lazy_document {
+    lazy_document(lazy_document&&) noexcept = default;
+    auto operator=(lazy_document&&) noexcept -> lazy_document& = default;
+
+    [[nodiscard]] auto root() const noexcept -> lazy_value {
+        return lazy_value(this, 0);
+    }
+
+    auto operator*() const noexcept -> lazy_value {
+        return root();
+    }
+
+    friend auto parse_lazy(std::string_view, const parse_options&) noexcept -> result<lazy_document>;
+private:
+    friend struct lazy_value;
+    friend struct lazy_array;
+    friend struct lazy_object;
+    friend struct lazy_member;
+
+    lazy_document(std::string_view text, std::vector<std::uint32_t> index, std::vector<std::uint32_t> ends) noexcept
+    : m_text(text), m_index(std::move(index)), m_ends(std::move(ends)) {}
+
+    [[nodiscard]] auto offset(std::uint32_t pos) const noexcept -> std::size_t {
+        return m_index[pos];
+    }
+
+    [[nodiscard]] auto at(std::uint32_t pos) const noexcept -> char {
+        return m_text[m_index[pos]];
+    }
+
+    // Position just past the value at `pos`
+    [[nodiscard]] auto skip(std::uint32_t pos) const noexcept -> std::uint32_t {
+        const auto c = at(pos);
+        return (c == '[' || c == '{' ? m_ends[pos] : pos) + 1;
+    }
+
+    // Position of the element or member after the one at `value`, or of the closing bracket
+    [[nodiscard]] auto next(std::uint32_t value) const noexcept -> std::uint32_t {
+        const auto pos = skip(value);
+        return at(pos) == ',' ? pos + 1 : pos;
+    }
+
+    auto string_at(std::uint32_t pos) const -> std::string_view;
+    // As string_at, but an escaped string is only decoded into the scratch buffer, so the view lasts
+    // until the next call
+    auto key_at(std::uint32_t pos) const -> std::string_view;
+    auto scalar_at(std::uint32_t pos) const -> detail::scalar;
+
+    std::string_view m_text;
+    std::vector<std::uint32_t> m_index;
+    // For each opening bracket, the position of its closing bracket
+    std::vector<std::uint32_t> m_ends;
+    // Escaped strings decoded so far, by position
+    mutable std::unordered_map<std::uint32_t, std::string> m_decoded;
+    mutable std::string m_scratch;
+};
+
+auto parse_lazy(std::string_view, const parse_options& = {}) noexcept -> result<lazy_document>;
+
+namespace detail {
+
+// Walks the structural index as the parser would walk the text, reporting the same errors for
+// anything malformed other than a scalar, and records where each array and object closes in `ends`
+auto check_structure(std::string_view s, const std::vector<std::uint32_t>& index, std::vector<std::uint32_t>& ends,
+                     const parse_options& options) noexcept -> std::optional<error>;
+
+}
+
+}
+
+#endif
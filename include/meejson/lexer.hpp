@@ -1,10 +1,15 @@
 #ifndef JSON_LEXER_HPP
 #define JSON_LEXER_HPP
 
+#include <algorithm>
 #include <variant>
 #include <cstdint>
 #include <compare>
 #include <vector>
+#include <optional>
+#include <memory_resource>
+#include <system_error>
+#include <utility>
 
 #include "value.hpp"
 
@@ -29,6 +34,164 @@ struct token {
 
 auto lex(std::string_view) noexcept -> result<std::vector<token>>;
 
+namespace detail {
+
+// Offsets of every structural character, opening quote and first byte of every other scalar that
+// lies outside a string, found 64 bytes at a time. The input must be smaller than 4 GiB.
+auto index_structurals(std::string_view) -> std::vector<std::uint32_t>;
+
+struct number_result {
+    const char* ptr;
+    std::errc ec;
+    std::variant<std::int64_t, double> value;
+};
+
+// Converts the JSON number at the start of [first, last) without allocating. `ptr` is one past the
+// last byte consumed; `ec` is invalid_argument for malformed numbers and result_out_of_range for
+// numbers too large for a double. Integers that don't fit in an int64_t are returned as doubles.
+auto scan_number(const char* first, const char* last) noexcept -> number_result;
+
+// First quote, backslash or control character in [first, last), or last if there is none
+auto find_string_special(const char* first, const char* last) noexcept -> const char*;
+
+using scalar = std::variant<null, bool, std::int64_t, double>;
+
+// The number or literal at the start of [first, last), if it is well formed and followed by
+// whitespace, a structural character or the end. No position is tracked, so reading a scalar in
+// the middle of a large input costs the same as at its start; lex_token() describes anything else.
+auto scan_scalar(const char* first, const char* last) noexcept -> std::optional<scalar>;
+
+// The token as it would appear in the source, for error messages
+auto to_string(const token&) noexcept -> std::string;
+
+// Pull based lexer over a contiguous buffer. lex() produces the whole token vector, while the
+// parser drives skip_whitespace()/peek()/lex_token() directly so no intermediate vector is built.
+// Only the byte offset is tracked while lexing; line and column are recovered on demand.
+struct lexer {
+    explicit lexer(std::string_view s) noexcept
+    : m_begin(s.data()), m_iter(s.data()), m_end(s.data() + s.size()), m_pos_iter(s.data()), m_line_begin(s.data()) {}
+
+    // With a structural index, skip_whitespace() jumps straight to the next indexed offset
+    lexer(std::string_view s, const std::vector<std::uint32_t>& index) noexcept : lexer(s) {
+        m_index_begin = index.data();
+        m_index = index.data();
+        m_index_end = index.data() + index.size();
+    }
+
+    constexpr static auto is_int(char c) noexcept -> bool {
+        return c >= '0' && c <= '9';
+    }
+
+    constexpr static auto is_hex(char c) noexcept -> bool {
+        return is_int(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    constexpr static auto is_whitespace(char c) noexcept -> bool {
+        return c == 0x20 || c == 0x0A || c == 0x0D || c == 0x09;
+    }
+
+    constexpr static auto is_alpha(char c) noexcept -> bool {
+        return c >= 'a' && c <= 'z';
+    }
+
+    constexpr static auto is_exponent(char c) noexcept -> bool {
+        return c == 'e' || c == 'E';
+    }
+
+    constexpr static auto is_structural(char c) noexcept -> bool {
+        return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+    }
+
+    [[nodiscard]] auto at_end() const noexcept -> bool {
+        return m_iter == m_end;
+    }
+
+    [[nodiscard]] auto peek() const noexcept -> char {
+        return *m_iter;
+    }
+
+    [[nodiscard]] auto line() const noexcept -> std::int32_t {
+        return position(m_iter).first;
+    }
+
+    [[nodiscard]] auto col() const noexcept -> std::int32_t {
+        return position(m_iter).second;
+    }
+
+    void advance() noexcept {
+        m_iter++;
+    }
+
+    // Carries on from byte `offset`, keeping positions relative to the start of the input
+    void seek(std::size_t offset) noexcept {
+        m_iter = m_begin + offset;
+        if (m_index) {
+            m_index = std::lower_bound(m_index_begin, m_index_end, std::uint32_t(offset));
+        }
+    }
+
+    [[nodiscard]] auto offset() const noexcept -> std::size_t {
+        return std::size_t(m_iter - m_begin);
+    }
+
+    // Skips whitespace, returning false if the end of input was reached
+    auto skip_whitespace() noexcept -> bool;
+
+    auto lex() noexcept -> result<std::vector<token>>;
+
+    // Lexes the single token starting at the current (non-whitespace) character
+    auto lex_token() noexcept -> result<token>;
+
+    auto lex_number() noexcept -> result<token>;
+    auto lex_string() noexcept -> result<token>;
+    auto lex_literal() noexcept -> result<token>;
+
+    // Decodes the string starting at the current quote onto the end of `out`. Instantiated for
+    // std::string and std::pmr::string.
+    template <class String>
+    auto lex_string(String& out) noexcept -> std::optional<json::error>;
+
+    // Checks the string starting at the current quote and moves past it, without decoding it
+    auto skip_string() noexcept -> std::optional<json::error>;
+
+    // Checks the number at the current character against the grammar and moves past it, rejecting
+    // those too large for a double as lex_number() does. Only numbers near that limit are converted.
+    auto skip_number() noexcept -> std::optional<json::error>;
+
+    // The string starting at the current quote. Strings without escapes are viewed in place;
+    // anything else is decoded into `scratch`, which the view then refers to.
+    auto lex_string_view(std::string& scratch) noexcept -> result<std::string_view>;
+
+    // Error naming the token at the current character as `prefix` token `suffix`
+    auto unexpected_token(std::string_view prefix, std::string_view suffix) noexcept -> json::error;
+
+private:
+    using iterator = const char*;
+
+    // Line and column of `it`, counted forward from the last position asked for
+    auto position(iterator it) const noexcept -> std::pair<std::int32_t, std::int32_t>;
+    auto error_at(iterator it, std::string msg) const noexcept -> json::error;
+
+    // Scalars must be followed by whitespace, a structural character or the end of input
+    auto check_terminated(iterator start) const noexcept -> std::optional<json::error>;
+
+    auto lex_escape() noexcept -> result<char>;
+    auto lex_hex4() noexcept -> std::optional<std::uint16_t>;
+    auto lex_unicode() noexcept -> result<std::uint32_t>;
+
+    iterator m_begin;
+    iterator m_iter;
+    iterator m_end;
+    const std::uint32_t* m_index_begin = nullptr;
+    const std::uint32_t* m_index = nullptr;
+    const std::uint32_t* m_index_end = nullptr;
+    mutable iterator m_pos_iter;
+    mutable iterator m_line_begin;
+    mutable std::int32_t m_line = 1;
+};
+
+}
+
 }
 
 #endif
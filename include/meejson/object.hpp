@@ -2,15 +2,100 @@
 #define OBJECT_JSON_HPP
 
 #include "box.hpp"
+#include "detail.hpp"
+#include "serializer.hpp"
 #include <iostream>
 #include <unordered_map>
 #include <algorithm>
+#include <cstdint>
 #include <ranges>
+#include <stdexcept>
+#include <string_view>
 
 namespace mee::json {
 
 namespace detail {
 
+// MurmurHash64A, written so it can also run at compile time. The byte loop compiles to a load.
+constexpr auto hash_key(std::string_view s) noexcept -> std::size_t {
+    constexpr auto m = std::uint64_t(0xC6A4A7935BD1E995);
+    constexpr auto r = 47;
+    const auto load = [&s](std::size_t offset, std::size_t n) {
+        auto word = std::uint64_t(0);
+        for (auto i = std::size_t(0); i < n; i++) {
+            word |= std::uint64_t(static_cast<unsigned char>(s[offset + i])) << (8 * i);
+        }
+        return word;
+    };
+    auto h = std::uint64_t(0x9E3779B97F4A7C15) ^ (s.size() * m);
+    auto offset = std::size_t(0);
+    for (; s.size() - offset >= 8; offset += 8) {
+        auto k = load(offset, 8) * m;
+        k ^= k >> r;
+        h = (h ^ (k * m)) * m;
+    }
+    if (offset != s.size()) {
+        h = (h ^ load(offset, s.size() - offset)) * m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return std::size_t(h);
+}
+
+}
+
+// A key with its hash computed up front, for lookups repeated across many objects
+struct hashed_key {
+    constexpr explicit hashed_key(std::string_view k) noexcept : key(k), hash(detail::hash_key(k)) {}
+
+    std::string_view key;
+    std::size_t hash;
+};
+
+namespace detail {
+
+// Transparent hash and equality, so objects can be searched by anything viewable as a string
+// without building a key
+struct key_hash {
+    using is_transparent = void;
+
+    // Deliberately not noexcept: libstdc++ then stores each node's hash, so walking a bucket
+    // compares hashes rather than rehashing every key it passes
+    constexpr auto operator()(std::string_view s) const -> std::size_t {
+        return hash_key(s);
+    }
+
+    constexpr auto operator()(const hashed_key& k) const noexcept -> std::size_t {
+        return k.hash;
+    }
+};
+
+struct key_equal {
+    using is_transparent = void;
+
+    constexpr auto operator()(std::string_view lhs, std::string_view rhs) const noexcept -> bool {
+        return lhs == rhs;
+    }
+
+    constexpr auto operator()(const hashed_key& lhs, std::string_view rhs) const noexcept -> bool {
+        return lhs.key == rhs;
+    }
+
+    constexpr auto operator()(std::string_view lhs, const hashed_key& rhs) const noexcept -> bool {
+        return lhs == rhs.key;
+    }
+};
+
+// Keys share the value's string type
+template <class Value>
+using object_storage = std::unordered_map<typename Value::string_type,
+                                          box<Value, value_allocator<Value>>,
+                                          key_hash,
+                                          key_equal,
+                                          rebind_alloc<value_allocator<Value>,
+                                                       std::pair<const typename Value::string_type, box<Value, value_allocator<Value>>>>>;
+
 template <class T>
 struct ptr_wrapper {
     explicit ptr_wrapper(const T& val) : m_ptr(val) {}
@@ -36,9 +121,9 @@ private:
 
 template <class Value>
 struct key_value_ref {
-    key_value_ref(std::pair<const std::string, detail::box<Value>>* p) : m_pair(p) {}
+    key_value_ref(typename object_storage<Value>::value_type* p) : m_pair(p) {}
 
-    [[nodiscard]] auto first() const noexcept -> const std::string& {
+    [[nodiscard]] auto first() const noexcept -> const typename Value::string_type& {
         return m_pair->first;
     }
 
@@ -57,19 +142,19 @@ struct key_value_ref {
         return ptr_wrapper(*this);
     }
 
-    operator std::pair<const std::string, Value>() const noexcept {
+    operator std::pair<const typename Value::string_type, Value>() const noexcept {
         return {m_pair->first, *m_pair->second};
     }
 
 private:
-    std::pair<const std::string, detail::box<Value>>* m_pair;
+    typename object_storage<Value>::value_type* m_pair;
 };
 
 template <class Value>
 struct const_key_value_ref {
-    const_key_value_ref(const std::pair<const std::string, detail::box<Value>>* p) : m_pair(p) {}
+    const_key_value_ref(const typename object_storage<Value>::value_type* p) : m_pair(p) {}
 
-    [[nodiscard]] auto first() const noexcept -> const std::string& {
+    [[nodiscard]] auto first() const noexcept -> const typename Value::string_type& {
         return m_pair->first;
     }
 
@@ -88,19 +173,19 @@ struct const_key_value_ref {
         return ptr_wrapper(*this);
     }
 
-    operator std::pair<const std::string, Value>() const noexcept {
+    operator std::pair<const typename Value::string_type, Value>() const noexcept {
         return {m_pair->first, *m_pair->second};
     }
 private:
-    const std::pair<const std::string, detail::box<Value>>* m_pair;
+    const typename object_storage<Value>::value_type* m_pair;
 };
 
 template <bool IsConst, class Value>
 struct object_iterator {
-    using base_type = typename std::unordered_map<std::string, box<Value>>::iterator;
-    using const_base_type = typename std::unordered_map<std::string, box<Value>>::const_iterator;
+    using base_type = typename object_storage<Value>::iterator;
+    using const_base_type = typename object_storage<Value>::const_iterator;
     using difference_type = std::conditional_t<IsConst, typename const_base_type::difference_type, typename base_type::difference_type>;
-    using value_type = std::pair<const std::string, Value>;
+    using value_type = std::pair<const typename Value::string_type, Value>;
     using reference = std::conditional_t<IsConst, const_key_value_ref<Value>, key_value_ref<Value>>;
     using pointer = detail::ptr_wrapper<reference>;
     using iterator_category = std::forward_iterator_tag;
@@ -152,14 +237,14 @@ using const_object_iterator = detail::object_iterator<true, Value>;
 
 template <class Value>
 struct basic_object {
-    using key_type = std::string;
+    using key_type = typename Value::string_type;
     using mapped_type = Value;
-    using value_type = std::pair<const std::string, Value>;
-    using size_type = typename std::unordered_map<std::string, detail::box<Value>>::size_type;
-    using difference_type = typename std::unordered_map<std::string, detail::box<Value>>::difference_type;
-    using hasher = std::hash<std::string>;
-    using key_equal = std::equal_to<std::string>;
-    using allocator_type = std::allocator<std::pair<const std::string, detail::box<Value>>>;
+    using value_type = std::pair<const key_type, Value>;
+    using size_type = typename detail::object_storage<Value>::size_type;
+    using difference_type = typename detail::object_storage<Value>::difference_type;
+    using hasher = detail::key_hash;
+    using key_equal = detail::key_equal;
+    using allocator_type = typename detail::object_storage<Value>::allocator_type;
     using reference = detail::key_value_ref<Value>;
     using const_reference = detail::const_key_value_ref<Value>;
     using pointer = detail::ptr_wrapper<reference>;
@@ -171,6 +256,7 @@ struct basic_object {
     static_assert(std::input_iterator<const_iterator>);
 
     basic_object() noexcept = default;
+    explicit basic_object(const allocator_type& alloc) noexcept : m_obj(alloc) {}
     basic_object(const basic_object& other) : basic_object(other.begin(), other.end()) {}
     basic_object(basic_object&&) noexcept = default;
     explicit basic_object(size_type n) : m_obj(n) {}
@@ -180,14 +266,16 @@ struct basic_object {
     basic_object(Iter first, Iter last) requires std::input_iterator<Iter> {
         for (; first != last; first++) {
             const auto& [k, v] = *first;
-            m_obj.try_emplace(k, detail::make_box<Value>(v));
+            m_obj.try_emplace(k, make_element(v));
         }
     }
 
+    auto operator=(basic_object&&) noexcept -> basic_object& = default;
+
     auto operator=(const basic_object& other) -> basic_object& {
         clear();
         for (const auto& [k, v] : other.m_obj) {
-            m_obj.try_emplace(k, detail::make_box<Value>(*v));
+            m_obj.try_emplace(k, make_element(*v));
         }
         return *this;
     }
@@ -195,13 +283,13 @@ struct basic_object {
     auto operator=(std::initializer_list<value_type> list) -> basic_object& {
         clear();
         for (const auto& [k, v] : list) {
-            m_obj.try_emplace(k, detail::make_box<Value>(v));
+            m_obj.try_emplace(k, make_element(v));
         }
         return *this;
     }
 
     auto get_allocator() const noexcept -> allocator_type {
-        return allocator_type();
+        return m_obj.get_allocator();
     }
 
     auto begin() noexcept -> iterator {
@@ -245,12 +333,12 @@ struct basic_object {
     }
 
     auto insert(const value_type& v) -> std::pair<iterator, bool> {
-        auto p = m_obj.insert(std::pair(v.first, detail::make_box<Value>(v.second)));
+        auto p = m_obj.insert(std::pair(v.first, make_element(v.second)));
         return std::pair(iterator(p.first), p.second);
     }
 
     auto insert(value_type&& v) -> std::pair<iterator, bool> {
-        auto p = m_obj.insert(std::pair(std::move(v.first), detail::make_box<Value>(std::move(v.second))));
+        auto p = m_obj.insert(std::pair(std::move(v.first), make_element(std::move(v.second))));
         return std::pair(iterator(p.first), p.second);
     }
 
@@ -258,8 +346,12 @@ struct basic_object {
         return iterator(m_obj.erase(it.get_base()));
     }
 
-    auto erase(const key_type& k) -> bool {
-        return m_obj.erase(k);
+    auto erase(std::string_view k) -> bool {
+        return erase_key(k);
+    }
+
+    auto erase(const hashed_key& k) -> bool {
+        return erase_key(k);
     }
 
     void swap(basic_object& o) noexcept {
@@ -274,68 +366,87 @@ struct basic_object {
         m_obj.merge(std::move(o.m_obj));
     }
 
-    auto at(const key_type& k) -> Value& {
-        return *m_obj.at(k);
+    auto at(std::string_view k) -> Value& {
+        return at_key(*this, k);
+    }
+
+    auto at(std::string_view k) const -> const Value& {
+        return at_key(*this, k);
     }
 
-    auto at(const key_type& k) const -> const Value& {
-        return *m_obj.at(k);
+    auto at(const hashed_key& k) -> Value& {
+        return at_key(*this, k);
+    }
+
+    auto at(const hashed_key& k) const -> const Value& {
+        return at_key(*this, k);
     }
 
     auto operator[](const key_type& k) -> Value& {
         auto& val = m_obj[k];
         if (!bool(val))
-            val = detail::make_box<Value>();
+            val = make_element();
         return *val;
     }
 
     auto operator[](key_type&& k) -> Value& {
         auto& val = m_obj[std::move(k)];
         if (!bool(val))
-            val = detail::make_box<Value>();
+            val = make_element();
         return *val;
     }
 
-    auto find(const key_type& k) -> iterator {
+    auto find(std::string_view k) -> iterator {
+        return iterator(m_obj.find(k));
+    }
+
+    auto find(std::string_view k) const -> const_iterator {
+        return const_iterator(m_obj.find(k));
+    }
+
+    auto find(const hashed_key& k) -> iterator {
         return iterator(m_obj.find(k));
     }
 
-    auto find(const key_type& k) const -> const_iterator {
+    auto find(const hashed_key& k) const -> const_iterator {
         return const_iterator(m_obj.find(k));
     }
 
-    [[nodiscard]] auto contains(const key_type& k) const -> bool {
+    [[nodiscard]] auto contains(std::string_view k) const -> bool {
+        return m_obj.contains(k);
+    }
+
+    [[nodiscard]] auto contains(const hashed_key& k) const -> bool {
         return m_obj.contains(k);
     }
 
     template <class P> requires std::is_constructible_v<value_type, P&&>
     auto insert(P&& value) -> std::pair<iterator, bool> {
-        auto p = std::pair(std::forward<P>(value));
-        auto p2 = m_obj.insert(std::pair(p.first, detail::make_box<Value>(p.second)));
-        return std::pair(iterator(p2.first), p2.second);
+        auto p = m_obj.try_emplace(std::forward<P>(value).first, make_element(std::forward<P>(value).second));
+        return std::pair(iterator(p.first), p.second);
     }
 
     template <class M> requires std::is_constructible_v<mapped_type, M&&>
     auto insert_or_assign(const key_type& k, M&& obj) -> std::pair<iterator, bool> {
-        auto p = m_obj.insert_or_assign(k, detail::make_box<Value>(std::forward<M>(obj)));
+        auto p = m_obj.insert_or_assign(k, make_element(std::forward<M>(obj)));
         return std::pair(iterator(p.first), p.second);
     }
 
     template <class M> requires std::is_constructible_v<mapped_type, M&&>
     auto insert_or_assign(key_type&& k, M&& obj) -> std::pair<iterator, bool> {
-        auto p = m_obj.insert_or_assign(std::move(k), detail::make_box<Value>(std::forward<M>(obj)));
+        auto p = m_obj.insert_or_assign(std::move(k), make_element(std::forward<M>(obj)));
         return std::pair(iterator(p.first), p.second);
     }
 
     template <class... Args>
     auto emplace(const key_type& k, Args&&... args) -> std::pair<iterator, bool> {
-        auto p = m_obj.try_emplace(k, detail::make_box<Value>(std::forward<Args>(args)...));
+        auto p = m_obj.try_emplace(k, make_element(std::forward<Args>(args)...));
         return std::pair(iterator(p.first), p.second);
     }
 
     template <class... Args>
     auto emplace(key_type&& k, Args&&... args) -> std::pair<iterator, bool> {
-        auto p = m_obj.try_emplace(std::move(k), detail::make_box<Value>(std::forward<Args>(args)...));
+        auto p = m_obj.try_emplace(std::move(k), make_element(std::forward<Args>(args)...));
         return std::pair(iterator(p.first), p.second);
     }
 
@@ -353,23 +464,39 @@ struct basic_object {
         });
     }
 private:
-    std::unordered_map<std::string, detail::box<Value>> m_obj;
+    template <class Self, class K>
+    static auto at_key(Self& self, const K& k) -> decltype(self.begin()->second()) {
+        auto it = self.find(k);
+        if (it == self.end()) {
+            throw std::out_of_range("basic_object::at");
+        }
+        return it->second();
+    }
+
+    // std::unordered_map only gains heterogeneous erase in C++23
+    template <class K>
+    auto erase_key(const K& k) -> bool {
+        auto it = m_obj.find(k);
+        if (it == m_obj.end()) {
+            return false;
+        }
+        m_obj.erase(it);
+        return true;
+    }
+
+    template <class... Args>
+    auto make_element(Args&&... args) const -> detail::box<Value, detail::value_allocator<Value>> {
+        return detail::allocate_box<Value>(get_allocator(), std::forward<Args>(args)...);
+    }
+
+    detail::object_storage<Value> m_obj;
 };
 
 template <class Value>
 auto operator<<(std::ostream& os, const basic_object<Value>& obj) noexcept -> std::ostream& {
-    os << '{';
-    auto iter = obj.begin();
-    if (iter != obj.end()) {
-        os << "\"" << iter->first() << "\"" << ':' << iter->second();
-        iter++;
-        for (; iter != obj.end(); iter++) {
-            const auto& [key, val] = *iter;
-            os << ',' << "\"" << key << "\"" << ':' << val;
-        }
-    }
-    os << '}';
-    return os;
+    auto out = std::string();
+    detail::dump_object(obj, out);
+    return os << out;
 }
 
 }
@@ -377,12 +504,12 @@ auto operator<<(std::ostream& os, const basic_object<Value>& obj) noexcept -> st
 namespace std {
     template <class Value> struct tuple_size<mee::json::detail::key_value_ref<Value>> : std::integral_constant<size_t, 2> { };
 
-    template <class Value> struct tuple_element<0, mee::json::detail::key_value_ref<Value>> { using type = std::string; };
+    template <class Value> struct tuple_element<0, mee::json::detail::key_value_ref<Value>> { using type = typename Value::string_type; };
     template <class Value> struct tuple_element<1, mee::json::detail::key_value_ref<Value>> { using type = Value; };
 
     template <class Value> struct tuple_size<mee::json::detail::const_key_value_ref<Value>> : std::integral_constant<size_t, 2> { };
 
-    template <class Value> struct tuple_element<0, mee::json::detail::const_key_value_ref<Value>> { using type = std::string; };
+    template <class Value> struct tuple_element<0, mee::json::detail::const_key_value_ref<Value>> { using type = typename Value::string_type; };
     template <class Value> struct tuple_element<1, mee::json::detail::const_key_value_ref<Value>> { using type = Value; };
 }
 
@@ -0,0 +1,422 @@
+#ifndef JSON_ORDERED_OBJECT_HPP
+#define JSON_ORDERED_OBJECT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "detail.hpp"
+#include "serializer.hpp"
+#include "value.hpp"
+
+namespace mee::json {
+
+template <class Value>
+struct ordered_object;
+
+namespace detail {
+
+// A key and its value, stored inline. first() and second() match the references basic_object
+// hands out, so code written against either container works with both.
+template <class Value>
+struct ordered_member {
+    using key_type = typename Value::string_type;
+
+    template <class K, class... Args>
+    explicit ordered_member(K&& k, Args&&... args) : m_key(std::forward<K>(k)), m_value(std::forward<Args>(args)...) {}
+
+    [[nodiscard]] auto first() const noexcept -> const key_type& {
+        return m_key;
+    }
+
+    auto second() noexcept -> Value& {
+        return m_value;
+    }
+
+    [[nodiscard]] auto second() const noexcept -> const Value& {
+        return m_value;
+    }
+
+    template <std::size_t I>
+    decltype(auto) get() noexcept {
+        static_assert(I == 0 || I == 1);
+        if constexpr (I == 0) return first();
+        else return second();
+    }
+
+    template <std::size_t I>
+    decltype(auto) get() const noexcept {
+        static_assert(I == 0 || I == 1);
+        if constexpr (I == 0) return first();
+        else return second();
+    }
+
+    operator std::pair<const key_type, Value>() const {
+        return {m_key, m_value};
+    }
+
+private:
+    friend struct ordered_object<Value>;
+
+    key_type m_key;
+    Value m_value;
+};
+
+}
+
+// Object storing its members contiguously in insertion order. Small objects are searched
+// linearly. Once an object grows past index_threshold members it also keeps an open addressing
+// table of member positions. The table is maintained on every insertion, since each insertion
+// has to look for a duplicate key anyway, so const lookups never modify the object.
+template <class Value>
+struct ordered_object {
+    using key_type = typename Value::string_type;
+    using mapped_type = Value;
+    using value_type = std::pair<const key_type, Value>;
+    using member_type = detail::ordered_member<Value>;
+    using allocator_type = detail::rebind_alloc<detail::value_allocator<Value>, member_type>;
+    using storage_type = std::vector<member_type, allocator_type>;
+    using size_type = typename storage_type::size_type;
+    using difference_type = typename storage_type::difference_type;
+    using hasher = detail::key_hash;
+    using key_equal = detail::key_equal;
+    using reference = member_type&;
+    using const_reference = const member_type&;
+    using iterator = typename storage_type::iterator;
+    using const_iterator = typename storage_type::const_iterator;
+
+    constexpr static size_type index_threshold = 8;
+
+    ordered_object() noexcept = default;
+    explicit ordered_object(const allocator_type& alloc) noexcept : m_members(alloc), m_index(alloc) {}
+    ordered_object(const ordered_object&) = default;
+    ordered_object(ordered_object&&) noexcept = default;
+
+    explicit ordered_object(size_type n) {
+        reserve(n);
+    }
+
+    ordered_object(std::initializer_list<value_type> list) : ordered_object(list.begin(), list.end()) {}
+
+    template <class Iter> requires std::input_iterator<Iter>
+    ordered_object(Iter first, Iter last) {
+        for (; first != last; first++) {
+            const auto& [k, v] = *first;
+            emplace(k, v);
+        }
+    }
+
+    auto operator=(const ordered_object&) -> ordered_object& = default;
+    auto operator=(ordered_object&&) noexcept -> ordered_object& = default;
+
+    auto operator=(std::initializer_list<value_type> list) -> ordered_object& {
+        clear();
+        for (const auto& [k, v] : list) {
+            emplace(k, v);
+        }
+        return *this;
+    }
+
+    auto get_allocator() const noexcept -> allocator_type {
+        return m_members.get_allocator();
+    }
+
+    auto begin() noexcept -> iterator {
+        return m_members.begin();
+    }
+
+    auto begin() const noexcept -> const_iterator {
+        return m_members.begin();
+    }
+
+    auto cbegin() const noexcept -> const_iterator {
+        return m_members.cbegin();
+    }
+
+    auto end() noexcept -> iterator {
+        return m_members.end();
+    }
+
+    auto end() const noexcept -> const_iterator {
+        return m_members.end();
+    }
+
+    auto cend() const noexcept -> const_iterator {
+        return m_members.cend();
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_members.empty();
+    }
+
+    auto size() const noexcept -> size_type {
+        return m_members.size();
+    }
+
+    auto max_size() const noexcept -> size_type {
+        return std::min<size_type>(m_members.max_size(), std::numeric_limits<std::uint32_t>::max() - 1);
+    }
+
+    void reserve(size_type n) {
+        m_members.reserve(n);
+    }
+
+    void clear() noexcept {
+        m_members.clear();
+        m_index.clear();
+    }
+
+    auto insert(const value_type& v) -> std::pair<iterator, bool> {
+        return emplace(v.first, v.second);
+    }
+
+    auto insert(value_type&& v) -> std::pair<iterator, bool> {
+        return emplace(v.first, std::move(v.second));
+    }
+
+    template <class P> requires std::is_constructible_v<value_type, P&&>
+    auto insert(P&& value) -> std::pair<iterator, bool> {
+        return emplace(std::forward<P>(value).first, std::forward<P>(value).second);
+    }
+
+    // Later members shift down to keep the order, so erasing is linear
+    auto erase(const_iterator it) -> iterator {
+        auto next = m_members.erase(it);
+        rebuild_index();
+        return next;
+    }
+
+    auto erase(std::string_view k) -> bool {
+        return erase_key(k);
+    }
+
+    auto erase(const hashed_key& k) -> bool {
+        return erase_key(k);
+    }
+
+    void swap(ordered_object& o) noexcept {
+        m_members.swap(o.m_members);
+        m_index.swap(o.m_index);
+    }
+
+    // As with std::unordered_map::merge, members whose keys are already present stay in `o`
+    void merge(ordered_object& o) {
+        auto rest = storage_type(o.get_allocator());
+        for (auto& member : o.m_members) {
+            if (position(std::string_view(member.m_key)) == size()) {
+                m_members.push_back(std::move(member));
+                index_inserted();
+            } else {
+                rest.push_back(std::move(member));
+            }
+        }
+        o.m_members = std::move(rest);
+        o.rebuild_index();
+    }
+
+    void merge(ordered_object&& o) {
+        merge(o);
+    }
+
+    auto at(std::string_view k) -> Value& {
+        return at_key(*this, k);
+    }
+
+    auto at(std::string_view k) const -> const Value& {
+        return at_key(*this, k);
+    }
+
+    auto at(const hashed_key& k) -> Value& {
+        return at_key(*this, k);
+    }
+
+    auto at(const hashed_key& k) const -> const Value& {
+        return at_key(*this, k);
+    }
+
+    auto operator[](const key_type& k) -> Value& {
+        return emplace(k).first->m_value;
+    }
+
+    auto operator[](key_type&& k) -> Value& {
+        return emplace(std::move(k)).first->m_value;
+    }
+
+    auto find(std::string_view k) -> iterator {
+        return begin() + difference_type(position(k));
+    }
+
+    auto find(std::string_view k) const -> const_iterator {
+        return begin() + difference_type(position(k));
+    }
+
+    auto find(const hashed_key& k) -> iterator {
+        return begin() + difference_type(position(k));
+    }
+
+    auto find(const hashed_key& k) const -> const_iterator {
+        return begin() + difference_type(position(k));
+    }
+
+    [[nodiscard]] auto contains(std::string_view k) const -> bool {
+        return position(k) != size();
+    }
+
+    [[nodiscard]] auto contains(const hashed_key& k) const -> bool {
+        return position(k) != size();
+    }
+
+    template <class M> requires std::is_constructible_v<mapped_type, M&&>
+    auto insert_or_assign(const key_type& k, M&& obj) -> std::pair<iterator, bool> {
+        return assign_member(k, std::forward<M>(obj));
+    }
+
+    template <class M> requires std::is_constructible_v<mapped_type, M&&>
+    auto insert_or_assign(key_type&& k, M&& obj) -> std::pair<iterator, bool> {
+        return assign_member(std::move(k), std::forward<M>(obj));
+    }
+
+    template <class... Args>
+    auto emplace(const key_type& k, Args&&... args) -> std::pair<iterator, bool> {
+        return emplace_member(k, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    auto emplace(key_type&& k, Args&&... args) -> std::pair<iterator, bool> {
+        return emplace_member(std::move(k), std::forward<Args>(args)...);
+    }
+
+    // Members compare regardless of order, as JSON objects do
+    auto operator==(const ordered_object& other) const noexcept -> bool {
+        if (size() != other.size()) {
+            return false;
+        }
+        return std::all_of(begin(), end(), [&other](const member_type& member) {
+            auto o = other.find(std::string_view(member.m_key));
+            return o != other.end() && member.m_value == o->m_value;
+        });
+    }
+
+private:
+    // Positions are stored one based, so a zero slot is empty
+    using index_type = std::vector<std::uint32_t, detail::rebind_alloc<allocator_type, std::uint32_t>>;
+
+    // Position of `k`, or size() if it isn't present
+    template <class K>
+    auto position(const K& k) const -> size_type {
+        if (m_index.empty()) {
+            for (auto i = size_type(0); i < m_members.size(); i++) {
+                if (key_equal()(k, m_members[i].m_key)) {
+                    return i;
+                }
+            }
+            return size();
+        }
+        const auto mask = m_index.size() - 1;
+        for (auto slot = hasher()(k) & mask;; slot = (slot + 1) & mask) {
+            const auto p = m_index[slot];
+            if (p == 0) {
+                return size();
+            }
+            if (key_equal()(k, m_members[p - 1].m_key)) {
+                return p - 1;
+            }
+        }
+    }
+
+    template <class Self, class K>
+    static auto at_key(Self& self, const K& k) -> decltype(self.begin()->second()) {
+        const auto pos = self.position(k);
+        if (pos == self.size()) {
+            throw std::out_of_range("ordered_object::at");
+        }
+        return self.m_members[pos].second();
+    }
+
+    template <class K>
+    auto erase_key(const K& k) -> bool {
+        const auto pos = position(k);
+        if (pos == size()) {
+            return false;
+        }
+        erase(begin() + difference_type(pos));
+        return true;
+    }
+
+    template <class K, class... Args>
+    auto emplace_member(K&& k, Args&&... args) -> std::pair<iterator, bool> {
+        if (const auto pos = position(std::string_view(k)); pos != size()) {
+            return std::pair(begin() + difference_type(pos), false);
+        }
+        m_members.emplace_back(std::forward<K>(k), std::forward<Args>(args)...);
+        index_inserted();
+        return std::pair(end() - 1, true);
+    }
+
+    template <class K, class M>
+    auto assign_member(K&& k, M&& obj) -> std::pair<iterator, bool> {
+        if (const auto pos = position(std::string_view(k)); pos != size()) {
+            m_members[pos].m_value = Value(std::forward<M>(obj));
+            return std::pair(begin() + difference_type(pos), false);
+        }
+        return emplace_member(std::forward<K>(k), std::forward<M>(obj));
+    }
+
+    // Keeps the table at most half full
+    void index_inserted() {
+        if (m_index.empty() || size() * 2 > m_index.size()) {
+            rebuild_index();
+        } else {
+            index_place(size() - 1);
+        }
+    }
+
+    void rebuild_index() {
+        m_index.clear();
+        if (size() <= index_threshold) {
+            return;
+        }
+        m_index.resize(std::bit_ceil(size() * 4));
+        for (auto i = size_type(0); i < size(); i++) {
+            index_place(i);
+        }
+    }
+
+    void index_place(size_type pos) {
+        const auto mask = m_index.size() - 1;
+        auto slot = hasher()(std::string_view(m_members[pos].m_key)) & mask;
+        while (m_index[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        m_index[slot] = std::uint32_t(pos + 1);
+    }
+
+    storage_type m_members;
+    index_type m_index;
+};
+
+template <class Value>
+auto operator<<(std::ostream& os, const ordered_object<Value>& obj) noexcept -> std::ostream& {
+    auto out = std::string();
+    detail::dump_object(obj, out);
+    return os << out;
+}
+
+using ordered_value = basic_value<std::int64_t, double, std::string, basic_array, ordered_object>;
+
+}
+
+namespace std {
+    template <class Value> struct tuple_size<mee::json::detail::ordered_member<Value>> : std::integral_constant<size_t, 2> { };
+
+    template <class Value> struct tuple_element<0, mee::json::detail::ordered_member<Value>> { using type = const typename Value::string_type; };
+    template <class Value> struct tuple_element<1, mee::json::detail::ordered_member<Value>> { using type = Value; };
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef JSON_PARALLEL_HPP
+#define JSON_PARALLEL_HPP
+
+#include <cstddef>
+#include <string_view>
+
+#include "parser.hpp"
+
+namespace mee::json {
+
+struct parallel_options {
+    parse_options parse = {};
+    // Threads parsing, the calling thread included; 0 for one per core
+    std::size_t threads = 0;
+    // Arrays this deep or shallower, counting the root as 0, have their elements parsed in
+    // parallel. They are found through the arrays and objects above them.
+    std::size_t split_depth = 1;
+    // Arrays and objects shorter than this are parsed whole, however shallow
+    std::size_t min_split_bytes = std::size_t(1) << 16;
+};
+
+// Parses a single large document on several threads. The structural index is built and checked
+// first, which finds where every element of the large shallow arrays starts and ends. Those arrays
+// are then created with a null for each element, and runs of elements are parsed into their places
+// concurrently. Results and errors are the same as parse()'s, line and column included.
+template <class Value>
+auto parse_parallel(std::string_view, const parallel_options& = {}) noexcept -> result<Value>;
+
+auto parse_parallel(std::string_view, const parallel_options& = {}) noexcept -> result<value>;
+
+}
+
+#endif
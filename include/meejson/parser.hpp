@@ -6,8 +6,29 @@
 #include "lexer.hpp"
 
 namespace mee::json {
-auto parse(std::string_view) noexcept -> result<value>;
-auto parse(const std::vector<token>&) noexcept -> result<value>;
+struct projection;
+
+struct parse_options {
+    // Deepest nesting of arrays and objects accepted; anything deeper is a parse error. Values are
+    // parsed and destroyed without recursion, but copying, comparing and dumping them recurse once per
+    // level, so this also bounds the stack those use.
+    std::size_t max_depth = 1024;
+    // Only the values these paths reach are built; see projection.hpp. Used by parse() and the
+    // parsers built on it, and by parse_many(); the push parser, lazy document and cursor ignore it.
+    const projection* fields = nullptr;
+};
+
+auto parse(std::string_view, const parse_options& = {}) noexcept -> result<value>;
+// Parses into any basic_value; instantiated for json::value, json::compact::value and json::ordered_value
+template <class Value>
+auto parse(std::string_view, const parse_options& = {}) noexcept -> result<Value>;
+
+auto parse(const std::vector<token>&, const parse_options& = {}) noexcept -> result<value>;
+
+namespace detail {
+// Recursive descent over the same lexer, kept to compare against the iterative parser
+auto parse_recursive(std::string_view, const parse_options& = {}) noexcept -> result<value>;
+}
 
 auto operator""_json(const char*, std::size_t) -> value;
 }
@@ -0,0 +1,137 @@
+#ifndef JSON_PROJECTION_HPP
+#define JSON_PROJECTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sax.hpp"
+
+namespace mee::json {
+
+// The parts of a document to build, as JSON Pointers (RFC 6901) such as "/user/name". Each path
+// keeps the whole value it points to, along with the arrays and objects leading to it, and ""
+// keeps everything. Given as parse_options::fields, every other value is still checked, numbers
+// too large for a double included, but its strings aren't decoded, its numbers aren't converted
+// and nothing is allocated for it. Array elements left out are removed, so the elements kept move
+// up to fill the gaps.
+struct projection {
+    static constexpr auto npos = std::size_t(-1);
+
+    // Throws error_exception for a path that isn't a JSON Pointer
+    projection(std::initializer_list<std::string_view> paths);
+    explicit projection(const std::vector<std::string>& paths);
+
+    // The paths are kept as a tree of member names, with the root at 0
+    [[nodiscard]] auto child(std::size_t node, std::string_view key) const noexcept -> std::size_t;
+    [[nodiscard]] auto child(std::size_t node, std::size_t index) const noexcept -> std::size_t;
+
+    // Whether everything under `node` is kept
+    [[nodiscard]] auto whole(std::size_t node) const noexcept -> bool {
+        return m_nodes[node].whole;
+    }
+
+private:
+    struct node {
+        std::vector<std::pair<std::string, std::size_t>> children;
+        bool whole = false;
+    };
+
+    void add(std::string_view path);
+
+    std::vector<node> m_nodes = std::vector<node>(1);
+};
+
+namespace detail {
+
+// The unescaped reference tokens of a JSON Pointer
+auto split_pointer(std::string_view) -> result<std::vector<std::string>>;
+
+// Passes the values a projection keeps on to another handler
+template <sax_handler Handler>
+struct projecting_handler {
+    projecting_handler(Handler& handler, const projection& fields) noexcept : m_handler(handler), m_fields(fields) {}
+
+    [[nodiscard]] auto fields() const noexcept -> const projection& {
+        return m_fields;
+    }
+
+    auto skip_value() -> bool {
+        if (m_frames.empty()) {
+            m_next = 0;
+        } else if (m_frames.back().array) {
+            auto& top = m_frames.back();
+            m_next = m_fields.child(top.node, top.index++);
+        }
+        return m_next == projection::npos;
+    }
+
+    // Scalars on the way to a path rather than under one are left out
+    auto on_null() -> bool {
+        return !m_fields.whole(m_next) || m_handler.on_null();
+    }
+
+    auto on_bool(bool b) -> bool {
+        return !m_fields.whole(m_next) || m_handler.on_bool(b);
+    }
+
+    auto on_int(std::int64_t i) -> bool {
+        return !m_fields.whole(m_next) || m_handler.on_int(i);
+    }
+
+    auto on_double(double d) -> bool {
+        return !m_fields.whole(m_next) || m_handler.on_double(d);
+    }
+
+    auto on_string(std::string_view s) -> bool {
+        return !m_fields.whole(m_next) || m_handler.on_string(s);
+    }
+
+    auto on_key(std::string_view s) -> bool {
+        m_next = m_fields.child(m_frames.back().node, s);
+        return m_next == projection::npos || m_handler.on_key(s);
+    }
+
+    auto start_object() -> bool {
+        m_frames.push_back(frame{m_next, false, 0});
+        return m_handler.start_object();
+    }
+
+    auto start_array() -> bool {
+        m_frames.push_back(frame{m_next, true, 0});
+        return m_handler.start_array();
+    }
+
+    auto end_object() -> bool {
+        m_frames.pop_back();
+        return m_handler.end_object();
+    }
+
+    auto end_array() -> bool {
+        m_frames.pop_back();
+        return m_handler.end_array();
+    }
+
+private:
+    struct frame {
+        std::size_t node;
+        bool array;
+        std::size_t index;
+    };
+
+    Handler& m_handler;
+    const projection& m_fields;
+    std::vector<frame> m_frames;
+    // Node of the value about to start
+    std::size_t m_next = 0;
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,366 @@
+#ifndef JSON_PUSH_PARSER_HPP
+#define JSON_PUSH_PARSER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sax.hpp"
+
+namespace mee::json {
+
+// Parses JSON that arrives in pieces, passing each value to a SAX handler as soon as it is
+// complete. What the parser expects next and the stack of open aggregates are kept between calls.
+// A scalar cut off at the end of a piece, be it part of a string, a number, an escape or a
+// literal, is held back until the rest of it arrives, so only a single token is ever buffered.
+template <sax_handler Handler>
+struct basic_push_parser {
+    explicit basic_push_parser(Handler& handler, const parse_options& options = {}) noexcept
+    : m_handler(handler), m_options(options) {}
+
+    // Consumes the next piece of input. Errors are sticky: once one has been returned every later
+    // call returns it again.
+    auto feed(std::span<const char> chunk) noexcept -> std::optional<error> {
+        if (!m_error) {
+            m_error = consume(chunk.data(), chunk.data() + chunk.size());
+        }
+        m_offset += chunk.size();
+        return m_error;
+    }
+
+    auto feed(std::string_view chunk) noexcept -> std::optional<error> {
+        return feed(std::span(chunk.data(), chunk.size()));
+    }
+
+    // Marks the end of input, completing a trailing number or literal
+    auto finish() noexcept -> std::optional<error> {
+        if (m_error) {
+            return m_error;
+        }
+        m_chunk = nullptr;
+        if (!m_carry.empty()) {
+            m_error = scalar(m_carry.data(), m_carry.data() + m_carry.size());
+            m_carry.clear();
+            if (m_error) {
+                return m_error;
+            }
+        }
+        if (m_state != state::done) {
+            m_error = end_of_input();
+        }
+        return m_error;
+    }
+
+    // Whether a whole value has been seen. A top level number is only known to be whole once
+    // finish() is called.
+    [[nodiscard]] auto done() const noexcept -> bool {
+        return m_state == state::done;
+    }
+
+private:
+    enum class state {
+        value,
+        first_value,
+        first_key,
+        key,
+        colon,
+        comma,
+        done
+    };
+
+    auto consume(const char* p, const char* end) noexcept -> std::optional<error> {
+        m_chunk = p;
+        if (!m_carry.empty()) {
+            const auto token_end = scan_token(m_carry.front(), p, end);
+            if (!token_end) {
+                m_carry.append(p, end);
+                return std::nullopt;
+            }
+            m_carry.append(p, token_end);
+            p = token_end;
+            auto err = scalar(m_carry.data(), m_carry.data() + m_carry.size());
+            m_carry.clear();
+            if (err) {
+                return err;
+            }
+        }
+        while (true) {
+            p = skip_whitespace(p, end);
+            if (p == end) {
+                return std::nullopt;
+            }
+            const auto c = *p;
+            switch (m_state) {
+                case state::done:
+                    return unexpected_token(p, end, "Parser Error: Unexpected token ", "");
+                case state::colon:
+                    if (c != ':') {
+                        return unexpected_token(p, end, "Parser Error: Unexpected token '", "' expected ':'");
+                    }
+                    m_state = state::value;
+                    p++;
+                    continue;
+                case state::comma:
+                    if (c == ',') {
+                        m_state = m_stack.back() == '}' ? state::key : state::value;
+                        p++;
+                        continue;
+                    }
+                    if (c != m_stack.back()) {
+                        return unexpected_token(p, end, "Unexpected token '", "' Expected ','");
+                    }
+                    break;
+                case state::first_key:
+                case state::key:
+                    if (m_state == state::first_key && c == '}') {
+                        break;
+                    }
+                    if (c != '"') {
+                        return unexpected_token(p, end, "Parser Error: Invalid object key '", "', expecting string.");
+                    }
+                    if (auto err = begin_scalar(p, end)) {
+                        return err;
+                    }
+                    continue;
+                case state::first_value:
+                case state::value:
+                    if (m_state == state::first_value && c == ']') {
+                        break;
+                    }
+                    if (c == '[' || c == '{') {
+                        if (m_stack.size() >= m_options.max_depth) {
+                            return detail::depth_exceeded(m_line, column(p), m_options.max_depth);
+                        }
+                        if (!(c == '[' ? m_handler.start_array() : m_handler.start_object())) {
+                            return stopped(m_line, column(p));
+                        }
+                        m_stack.push_back(c == '[' ? ']' : '}');
+                        m_state = c == '[' ? state::first_value : state::first_key;
+                        p++;
+                        continue;
+                    }
+                    if (detail::lexer::is_structural(c)) {
+                        return unexpected_token(p, end, "Parser Error: Unexpected token ", "");
+                    }
+                    if (auto err = begin_scalar(p, end)) {
+                        return err;
+                    }
+                    continue;
+            }
+            // `c` closes the innermost aggregate
+            const auto line = m_line;
+            const auto col = column(p);
+            p++;
+            m_stack.pop_back();
+            const auto handled = c == ']' ? m_handler.end_array() : m_handler.end_object();
+            value_ended();
+            if (!handled) {
+                return stopped(line, col);
+            }
+        }
+    }
+
+    // Lexes the scalar starting at `p` if all of it is here, otherwise keeps what there is
+    auto begin_scalar(const char*& p, const char* end) noexcept -> std::optional<error> {
+        m_token_line = m_line;
+        m_token_col = column(p);
+        m_escaped = false;
+        const auto token_end = scan_token(*p, *p == '"' ? p + 1 : p, end);
+        if (!token_end) {
+            m_carry.assign(p, end);
+            p = end;
+            return std::nullopt;
+        }
+        const auto first = p;
+        p = token_end;
+        return scalar(first, token_end);
+    }
+
+    // One past the end of the token beginning with `first` whose remaining bytes start at `p`, or
+    // null if the token may carry on past `end`. Whether the previous byte opened an escape is
+    // remembered, since a piece can end between a backslash and the character it escapes.
+    auto scan_token(char first, const char* p, const char* end) noexcept -> const char* {
+        if (first != '"') {
+            while (p != end && !detail::lexer::is_whitespace(*p) && !detail::lexer::is_structural(*p)) {
+                p++;
+            }
+            return p == end ? nullptr : p;
+        }
+        while (true) {
+            if (m_escaped) {
+                if (p == end) {
+                    return nullptr;
+                }
+                p++;
+                m_escaped = false;
+            }
+            p = detail::find_string_special(p, end);
+            if (p == end) {
+                return nullptr;
+            }
+            if (*p != '\\') {
+                // The closing quote, or a control character for the lexer to reject
+                return p + 1;
+            }
+            m_escaped = true;
+            p++;
+        }
+    }
+
+    // Lexes the complete token [first, last) and reports it
+    auto scalar(const char* first, const char* last) noexcept -> std::optional<error> {
+        auto lex = detail::lexer(std::string_view(first, std::size_t(last - first)));
+        auto handled = true;
+        if (*first == '"') {
+            auto s = lex.lex_string_view(m_scratch);
+            if (!s) {
+                return at_token(std::move(s).error());
+            }
+            if (m_state == state::first_key || m_state == state::key) {
+                handled = m_handler.on_key(*s);
+                m_state = state::colon;
+            } else {
+                handled = m_handler.on_string(*s);
+                value_ended();
+            }
+        } else {
+            auto tok = lex.lex_token();
+            if (!tok) {
+                return at_token(std::move(tok).error());
+            }
+            handled = std::visit(detail::overload{
+            [this](null) -> bool { return m_handler.on_null(); },
+            [this](bool b) -> bool { return m_handler.on_bool(b); },
+            [this](std::int64_t i) -> bool { return m_handler.on_int(i); },
+            [this](double d) -> bool { return m_handler.on_double(d); },
+            [this](const std::string& s) -> bool { return m_handler.on_string(s); },
+            [](symbol) -> bool { return true; },
+            }, tok->tok);
+            value_ended();
+        }
+        if (!handled) {
+            return stopped(m_token_line, m_token_col);
+        }
+        return std::nullopt;
+    }
+
+    void value_ended() noexcept {
+        m_state = m_stack.empty() ? state::done : state::comma;
+    }
+
+    auto skip_whitespace(const char* p, const char* end) noexcept -> const char* {
+        while (p != end && detail::lexer::is_whitespace(*p)) {
+            if (*p == '\n') {
+                m_line++;
+                m_line_begin = offset(p) + 1;
+            }
+            p++;
+        }
+        return p;
+    }
+
+    [[nodiscard]] auto offset(const char* p) const noexcept -> std::size_t {
+        return m_offset + std::size_t(p - m_chunk);
+    }
+
+    [[nodiscard]] auto column(const char* p) const noexcept -> std::int32_t {
+        return std::int32_t(offset(p) - m_line_begin) + 1;
+    }
+
+    // Tokens never span lines, so errors from lexing one on its own only need their column moved
+    [[nodiscard]] auto at_token(error err) const noexcept -> error {
+        err.line = m_token_line;
+        err.col += m_token_col - 1;
+        return err;
+    }
+
+    auto unexpected_token(const char* p, const char* end, std::string_view prefix, std::string_view suffix) noexcept -> error {
+        m_token_line = m_line;
+        m_token_col = column(p);
+        auto lex = detail::lexer(std::string_view(p, std::size_t(end - p)));
+        return at_token(lex.unexpected_token(prefix, suffix));
+    }
+
+    [[nodiscard]] auto end_of_input() const noexcept -> error {
+        const auto col = std::int32_t(m_offset - m_line_begin) + 1;
+        switch (m_state) {
+            case state::value:
+                if (m_stack.empty()) {
+                    return error(1, 1, "Parser Error: Unable to parse empty string");
+                }
+                break;
+            case state::first_value:
+            case state::first_key:
+                return error(m_line, col, "Parser Error: Unexpected end of input, expected value");
+            case state::key:
+                return error(m_line, col, "Parser Error: Unexpected end of input, expecting key");
+            case state::colon:
+                return error(m_line, col, "Parser Error: Unexpected end of input, expecting ':'");
+            default:
+                break;
+        }
+        return error(m_line, col, "Parser Error: Unexpected end of input");
+    }
+
+    static auto stopped(std::int32_t line, std::int32_t col) noexcept -> error {
+        return error(line, col, "Parser Error: Stopped by handler");
+    }
+
+    Handler& m_handler;
+    parse_options m_options;
+    state m_state = state::value;
+    std::vector<char> m_stack;
+    std::optional<error> m_error;
+
+    // Bytes fed before the current piece, and where the current line began
+    std::size_t m_offset = 0;
+    std::size_t m_line_begin = 0;
+    const char* m_chunk = nullptr;
+    std::int32_t m_line = 1;
+
+    // A token cut off at the end of a piece
+    std::string m_carry;
+    bool m_escaped = false;
+    std::int32_t m_token_line = 1;
+    std::int32_t m_token_col = 1;
+    std::string m_scratch;
+};
+
+// Builds a json::value from input that arrives in pieces
+struct push_parser {
+    explicit push_parser(const parse_options& options = {}) : m_parser(m_builder, options) {}
+
+    push_parser(const push_parser&) = delete;
+    auto operator=(const push_parser&) -> push_parser& = delete;
+
+    auto feed(std::span<const char> chunk) noexcept -> std::optional<error> {
+        return m_parser.feed(chunk);
+    }
+
+    auto feed(std::string_view chunk) noexcept -> std::optional<error> {
+        return m_parser.feed(chunk);
+    }
+
+    [[nodiscard]] auto done() const noexcept -> bool {
+        return m_parser.done();
+    }
+
+    // Ends the input and hands over the value
+    auto finish() noexcept -> result<value> {
+        if (auto err = m_parser.finish()) {
+            return std::move(*err);
+        }
+        return m_builder.take();
+    }
+
+private:
+    detail::dom_builder<value> m_builder;
+    basic_push_parser<detail::dom_builder<value>> m_parser;
+};
+
+}
+
+#endif
@@ -0,0 +1,427 @@
+#ifndef JSON_QUERY_HPP
+#define JSON_QUERY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "value.hpp"
+
+namespace mee::json {
+
+struct query;
+struct query_set;
+
+namespace detail {
+
+using literal = std::variant<null, bool, std::int64_t, double, std::string>;
+
+// A member name, an element index counting from the end when negative, or both for a JSON Pointer
+// token that could be either. The name's hash is kept so objects are searched without rehashing.
+struct child_key {
+    std::optional<std::string> name;
+    std::size_t hash = 0;
+    std::optional<std::int64_t> index;
+
+    [[nodiscard]] auto hashed() const noexcept -> hashed_key {
+        auto k = hashed_key({});
+        k.key = *name;
+        k.hash = hash;
+        return k;
+    }
+};
+
+// `@` followed by `path`, tested for existence or compared with `value`
+struct comparison {
+    enum class op {
+        exists,
+        eq,
+        ne,
+        lt,
+        le,
+        gt,
+        ge
+    };
+
+    std::vector<child_key> path;
+    op oper = op::exists;
+    literal value;
+};
+
+struct selector {
+    enum class kind {
+        key,
+        wildcard,
+        filter
+    };
+
+    kind type = kind::key;
+    child_key key;
+    // Children for which every comparison of any one group holds
+    std::vector<std::vector<comparison>> filter;
+};
+
+// Picks children of the current values, or with `descendant` of the current values and everything
+// under them
+struct segment {
+    bool descendant = false;
+    std::vector<selector> selectors;
+};
+
+template <class Value>
+auto find_child(const Value& v, const child_key& k) -> const Value* {
+    if (auto obj = v.template get_if<typename Value::object_type>()) {
+        if (!k.name) {
+            return nullptr;
+        }
+        const auto it = obj->find(k.hashed());
+        return it == obj->end() ? nullptr : &it->second();
+    }
+    if (auto arr = v.template get_if<typename Value::array_type>(); arr && k.index) {
+        const auto size = std::int64_t(arr->size());
+        const auto i = *k.index < 0 ? size + *k.index : *k.index;
+        return i >= 0 && i < size ? &(*arr)[std::size_t(i)] : nullptr;
+    }
+    return nullptr;
+}
+
+using scalar_view = std::variant<null, bool, std::int64_t, double, std::string_view>;
+
+template <class Value>
+auto view_scalar(const Value& v) -> std::optional<scalar_view> {
+    return visit([]<class T>(const T& x) -> std::optional<scalar_view> {
+        if constexpr (std::same_as<T, typename Value::null_type>) {
+            return scalar_view(null());
+        } else if constexpr (std::same_as<T, typename Value::bool_type>) {
+            return scalar_view(bool(x));
+        } else if constexpr (std::same_as<T, typename Value::int_type>) {
+            return scalar_view(std::int64_t(x));
+        } else if constexpr (std::same_as<T, typename Value::float_type>) {
+            return scalar_view(double(x));
+        } else if constexpr (std::same_as<T, typename Value::string_type>) {
+            return scalar_view(std::string_view(x));
+        } else {
+            return std::nullopt;
+        }
+    }, v);
+}
+
+// Compares a scalar with a literal; unordered pairs only ever compare unequal
+auto compare(const std::optional<scalar_view>& lhs, comparison::op op, const literal& rhs) noexcept -> bool;
+
+template <class Value>
+auto test(const Value& v, const comparison& c) -> bool {
+    auto p = &v;
+    for (const auto& k : c.path) {
+        if (!(p = find_child(*p, k))) {
+            return c.oper == comparison::op::ne;
+        }
+    }
+    return c.oper == comparison::op::exists || compare(view_scalar(*p), c.oper, c.value);
+}
+
+template <class Value>
+auto test(const Value& v, const std::vector<std::vector<comparison>>& filter) -> bool {
+    for (const auto& all : filter) {
+        auto holds = true;
+        for (const auto& c : all) {
+            if (!(holds = test(v, c))) {
+                break;
+            }
+        }
+        if (holds) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class Value, class F>
+struct query_walker;
+
+}
+
+// A JSON Pointer (RFC 6901) or JSONPath (RFC 9535) expression, compiled once and run against any
+// number of values. The JSONPath subset covers names, indices, unions of them, wildcards, recursive
+// descent and filters comparing a member or element with a literal, joined by && and ||.
+struct query {
+    // Every value the query reaches, each once, in the order the walk comes across them
+    template <class Value> requires is_value<Value>::value
+    auto find(const Value& v) const -> std::vector<const Value*>;
+
+    template <class Value> requires is_value<Value>::value
+    auto find_first(const Value& v) const -> optional_ref<const Value>;
+
+private:
+    friend auto compile_query(std::string_view) -> result<query>;
+    friend struct query_set;
+    template <class Value, class F>
+    friend struct detail::query_walker;
+
+    std::vector<detail::segment> m_segments;
+};
+
+// Pointers are "" or start with '/'; JSONPath starts with '$'. Errors give the column in the query.
+auto compile_query(std::string_view) -> result<query>;
+
+namespace detail {
+
+// Walks a value once for any number of queries. Each value visited carries the (query, segment)
+// pairs that have reached it, so a subtree no query can reach is never entered, and a value that
+// queries can only reach by name or index is searched rather than scanned.
+template <class Value, class F>
+struct query_walker {
+    query_walker(const query* queries, F& f) noexcept : m_queries(queries), m_f(f) {}
+
+    // Has query `q` pick up from segment `seg` at the value given to the next run()
+    void start(std::uint32_t q, std::uint32_t seg) {
+        if (q >= m_seen.size()) {
+            m_seen.resize(q + 1);
+        }
+        m_states.push_back(state{q, seg});
+    }
+
+    void run(const Value& v) {
+        visit_value(v, 0);
+        m_states.clear();
+    }
+
+private:
+    struct state {
+        std::uint32_t query;
+        std::uint32_t segment;
+
+        auto operator==(const state&) const noexcept -> bool = default;
+    };
+
+    [[nodiscard]] auto segments(const state& s) const noexcept -> const std::vector<segment>& {
+        return m_queries[s.query].m_segments;
+    }
+
+    // Adds a state for the child whose states start at `first`, unless it is already there. Only a
+    // query that has reached the child before needs searching for.
+    void add(const state& s, std::size_t first) {
+        if (m_seen[s.query] != m_child) {
+            m_seen[s.query] = m_child;
+            m_states.push_back(s);
+            return;
+        }
+        for (auto i = first; i < m_states.size(); i++) {
+            if (m_states[i] == s) {
+                return;
+            }
+        }
+        m_states.push_back(s);
+    }
+
+    // The states from `first` on belong to `v`
+    void visit_value(const Value& v, std::size_t first) {
+        const auto last = m_states.size();
+        auto open = false;
+        auto direct = true;
+        for (auto i = first; i < last; i++) {
+            const auto s = m_states[i];
+            const auto& segs = segments(s);
+            if (s.segment == segs.size()) {
+                m_f(std::size_t(s.query), v);
+                continue;
+            }
+            open = true;
+            const auto& seg = segs[s.segment];
+            direct = direct && !seg.descendant;
+            for (const auto& sel : seg.selectors) {
+                direct = direct && sel.type == selector::kind::key;
+            }
+        }
+        if (!open) {
+            return;
+        }
+        if (direct) {
+            search(v, first, last);
+        } else if (auto arr = v.template get_if<typename Value::array_type>()) {
+            const auto size = std::int64_t(arr->size());
+            for (auto i = std::int64_t(0); i < size; i++) {
+                const auto& elem = (*arr)[std::size_t(i)];
+                step(elem, first, last, [i, size](const child_key& k) {
+                    return k.index && (*k.index < 0 ? size + *k.index : *k.index) == i;
+                });
+            }
+        } else if (auto obj = v.template get_if<typename Value::object_type>()) {
+            for (const auto& member : *obj) {
+                const auto name = std::string_view(member.first());
+                step(member.second(), first, last, [name](const child_key& k) {
+                    return k.name && *k.name == name;
+                });
+            }
+        }
+    }
+
+    // Carries the states [first, last) from a value on to its child `c`
+    template <class Match>
+    void step(const Value& c, std::size_t first, std::size_t last, Match&& match) {
+        const auto child_first = m_states.size();
+        m_child++;
+        for (auto i = first; i < last; i++) {
+            const auto s = m_states[i];
+            const auto& segs = segments(s);
+            if (s.segment == segs.size()) {
+                continue;
+            }
+            const auto& seg = segs[s.segment];
+            if (seg.descendant) {
+                add(s, child_first);
+            }
+            for (const auto& sel : seg.selectors) {
+                const auto hit = sel.type == selector::kind::wildcard || (sel.type == selector::kind::key ? match(sel.key) : test(c, sel.filter));
+                if (hit) {
+                    add(state{s.query, s.segment + 1}, child_first);
+                    break;
+                }
+            }
+        }
+        if (m_states.size() != child_first) {
+            visit_value(c, child_first);
+            m_states.resize(child_first);
+        }
+    }
+
+    // Looks each name and index up, visiting every child found once with all the states reaching it
+    void search(const Value& v, std::size_t first, std::size_t last) {
+        const auto targets = m_targets.size();
+        for (auto i = first; i < last; i++) {
+            const auto s = m_states[i];
+            const auto& segs = segments(s);
+            if (s.segment == segs.size()) {
+                continue;
+            }
+            for (const auto& sel : segs[s.segment].selectors) {
+                if (const auto c = find_child(v, sel.key)) {
+                    m_targets.emplace_back(c, state{s.query, s.segment + 1});
+                }
+            }
+        }
+        // Sorted, the states reaching each child sit together and duplicates are adjacent
+        const auto end = m_targets.size();
+        std::sort(m_targets.begin() + std::ptrdiff_t(targets), m_targets.end(), [](const auto& a, const auto& b) {
+            return a.first != b.first ? std::less<>()(a.first, b.first) : std::pair(a.second.query, a.second.segment) < std::pair(b.second.query, b.second.segment);
+        });
+        for (auto t = targets; t < end;) {
+            const auto c = m_targets[t].first;
+            const auto child_first = m_states.size();
+            for (; t < end && m_targets[t].first == c; t++) {
+                if (m_states.size() == child_first || !(m_states.back() == m_targets[t].second)) {
+                    m_states.push_back(m_targets[t].second);
+                }
+            }
+            visit_value(*c, child_first);
+            m_states.resize(child_first);
+        }
+        m_targets.resize(targets);
+    }
+
+    const query* m_queries;
+    F& m_f;
+    std::vector<state> m_states;
+    // For each query, the last child it reached, counting children as they are visited
+    std::vector<std::size_t> m_seen;
+    std::size_t m_child = 0;
+    std::vector<std::pair<const Value*, state>> m_targets;
+};
+
+}
+
+// Queries run together in a single walk, however many there are
+struct query_set {
+    explicit query_set(std::vector<query> queries);
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_queries.size();
+    }
+
+    // Calls f(i, match) for each value query i reaches
+    template <class Value, class F> requires is_value<Value>::value
+    void for_each(const Value& v, F&& f) const {
+        auto walker = detail::query_walker<Value, F>(m_queries.data(), f);
+        walk(v, 0, f, walker);
+    }
+
+    // The values each query reaches, in the order the queries were given
+    template <class Value> requires is_value<Value>::value
+    auto evaluate(const Value& v) const -> std::vector<std::vector<const Value*>> {
+        auto results = std::vector<std::vector<const Value*>>(m_queries.size());
+        for_each(v, [&results](std::size_t q, const Value& match) {
+            results[q].push_back(&match);
+        });
+        return results;
+    }
+
+private:
+    // The leading member names and indices of the queries, merged into a tree so that a prefix
+    // the queries share is looked up once. Whatever follows is left to the walker.
+    struct node {
+        std::vector<std::pair<detail::child_key, std::uint32_t>> children;
+        std::vector<std::uint32_t> matches;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> rest;
+    };
+
+    template <class Value, class F, class Walker>
+    void walk(const Value& v, std::uint32_t n, F& f, Walker& walker) const {
+        const auto& nd = m_nodes[n];
+        for (const auto q : nd.matches) {
+            f(std::size_t(q), v);
+        }
+        if (!nd.rest.empty()) {
+            for (const auto& [q, seg] : nd.rest) {
+                walker.start(q, seg);
+            }
+            walker.run(v);
+        }
+        for (const auto& [key, child] : nd.children) {
+            if (const auto c = detail::find_child(v, key)) {
+                walk(*c, child, f, walker);
+            }
+        }
+    }
+
+    std::vector<query> m_queries;
+    std::vector<node> m_nodes;
+};
+
+template <class Value> requires is_value<Value>::value
+auto query::find(const Value& v) const -> std::vector<const Value*> {
+    auto matches = std::vector<const Value*>();
+    auto f = [&matches](std::size_t, const Value& match) {
+        matches.push_back(&match);
+    };
+    auto walker = detail::query_walker<Value, decltype(f)>(this, f);
+    walker.start(0, 0);
+    walker.run(v);
+    return matches;
+}
+
+template <class Value> requires is_value<Value>::value
+auto query::find_first(const Value& v) const -> optional_ref<const Value> {
+    // Pointers and plain paths never branch, so they are followed without a walker
+    auto p = &v;
+    for (const auto& seg : m_segments) {
+        if (seg.descendant || seg.selectors.size() != 1 || seg.selectors[0].type != detail::selector::kind::key) {
+            const auto matches = find(v);
+            return matches.empty() ? nullptr : matches[0];
+        }
+        if (!(p = detail::find_child(*p, seg.selectors[0].key))) {
+            return nullptr;
+        }
+    }
+    return p;
+}
+
+}
+
+#endif
@@ -0,0 +1,411 @@
+#ifndef JSON_SAX_HPP
+#define JSON_SAX_HPP
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "lexer.hpp"
+#include "parser.hpp"
+
+namespace mee::json {
+
+// Receives a document as a sequence of events in source order. Members of an object arrive as
+// on_key followed by the events of the value. Every event returns whether to carry on; returning
+// false stops the parse with an error. Strings are only valid for the duration of the call.
+template <class Handler>
+concept sax_handler = requires(Handler& h, bool b, std::int64_t i, double d, std::string_view s) {
+    { h.on_null() } -> std::convertible_to<bool>;
+    { h.on_bool(b) } -> std::convertible_to<bool>;
+    { h.on_int(i) } -> std::convertible_to<bool>;
+    { h.on_double(d) } -> std::convertible_to<bool>;
+    { h.on_string(s) } -> std::convertible_to<bool>;
+    { h.on_key(s) } -> std::convertible_to<bool>;
+    { h.start_object() } -> std::convertible_to<bool>;
+    { h.end_object() } -> std::convertible_to<bool>;
+    { h.start_array() } -> std::convertible_to<bool>;
+    { h.end_array() } -> std::convertible_to<bool>;
+};
+
+// A handler may also pick the values it wants. skip_value() is called as each value starts, after
+// its key if it is a member, and returning true has the value checked but not decoded or reported.
+template <class Handler>
+concept skipping_handler = requires(Handler& h) {
+    { h.skip_value() } -> std::convertible_to<bool>;
+};
+
+namespace detail {
+
+inline auto depth_exceeded(std::int32_t line, std::int32_t col, std::size_t max_depth) noexcept -> json::error {
+    return json::error(line, col, "Parser Error: Exceeded maximum nesting depth of " + std::to_string(max_depth));
+}
+
+// Walks the character stream without recursing, calling the handler for each value as it is
+// lexed. Only the closing character of each open array or object is kept, so nesting is bounded
+// by max_depth rather than by the call stack.
+template <sax_handler Handler>
+struct sax_parser {
+    sax_parser(const lexer& lex, Handler& handler, const parse_options& options) noexcept
+    : m_lexer(lex), m_handler(handler), m_options(options) {}
+
+    auto parse() noexcept -> std::optional<json::error> {
+        if (!m_lexer.skip_whitespace()) {
+            return json::error(1, 1, "Parser Error: Unable to parse empty string");
+        }
+        if (auto err = parse_value()) {
+            return err;
+        }
+        if (m_lexer.skip_whitespace()) {
+            return m_lexer.unexpected_token("Parser Error: Unexpected token ", "");
+        }
+        return std::nullopt;
+    }
+
+    // For input holding several values one after another: parses the value at the current
+    // position, leaving the lexer just past it
+    auto parse_next() noexcept -> std::optional<json::error> {
+        m_stack.clear();
+        m_skip = 0;
+        return parse_value();
+    }
+
+    auto get_lexer() noexcept -> lexer& {
+        return m_lexer;
+    }
+
+private:
+    auto parse_value() noexcept -> std::optional<json::error> {
+        while (true) {
+            if (!m_lexer.skip_whitespace()) {
+                return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input");
+            }
+            if constexpr (skipping_handler<Handler>) {
+                if (!skipping() && m_handler.skip_value()) {
+                    m_skip = m_stack.size() + 1;
+                }
+            }
+            if (const auto c = m_lexer.peek(); c == '[' || c == '{') {
+                if (m_stack.size() >= m_options.max_depth) {
+                    return depth_exceeded(m_lexer.line(), m_lexer.col(), m_options.max_depth);
+                }
+                if (!skipping() && !(c == '[' ? m_handler.start_array() : m_handler.start_object())) {
+                    return stopped();
+                }
+                m_lexer.advance();
+                const auto close = c == '[' ? ']' : '}';
+                m_stack.push_back(close);
+                if (!m_lexer.skip_whitespace()) {
+                    return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input, expected value");
+                }
+                if (m_lexer.peek() != close) {
+                    if (c == '{') {
+                        if (auto err = parse_key()) {
+                            return err;
+                        }
+                    }
+                    continue;
+                }
+                m_lexer.advance();
+                if (!close_aggregate()) {
+                    return stopped();
+                }
+            } else if (auto err = parse_scalar()) {
+                return err;
+            }
+
+            // Move past the separator after the finished value, closing every aggregate that ends here
+            while (true) {
+                if (m_stack.empty()) {
+                    return std::nullopt;
+                }
+                const auto close = m_stack.back();
+                if (!m_lexer.skip_whitespace()) {
+                    return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input");
+                }
+                if (m_lexer.peek() == ',') {
+                    m_lexer.advance();
+                    if (close == '}') {
+                        if (auto err = parse_key()) {
+                            return err;
+                        }
+                    }
+                    break;
+                }
+                if (m_lexer.peek() != close) {
+                    return m_lexer.unexpected_token("Unexpected token '", "' Expected ','");
+                }
+                m_lexer.advance();
+                if (!close_aggregate()) {
+                    return stopped();
+                }
+            }
+        }
+    }
+
+    auto parse_scalar() noexcept -> std::optional<json::error> {
+        if (skipping()) {
+            return skip_scalar();
+        }
+        if (m_lexer.peek() == '"') {
+            auto s = m_lexer.lex_string_view(m_scratch);
+            if (!s) {
+                return std::move(s).error();
+            }
+            return carry_on(m_handler.on_string(*s));
+        }
+        auto tok = m_lexer.lex_token();
+        if (!tok) {
+            return std::move(tok).error();
+        }
+        return std::visit(overload{
+        [this](null) { return carry_on(m_handler.on_null()); },
+        [this](bool b) { return carry_on(m_handler.on_bool(b)); },
+        [this](std::int64_t i) { return carry_on(m_handler.on_int(i)); },
+        [this](double d) { return carry_on(m_handler.on_double(d)); },
+        [this](const std::string& s) { return carry_on(m_handler.on_string(s)); },
+        [&tok](symbol) -> std::optional<json::error> {
+            return json::error(tok->line, tok->col, "Parser Error: Unexpected token " + to_string(*tok));
+        },
+        }, tok->tok);
+    }
+
+    // Checks a scalar inside a skipped value without decoding it
+    auto skip_scalar() noexcept -> std::optional<json::error> {
+        const auto c = m_lexer.peek();
+        auto err = std::optional<json::error>();
+        if (c == '"') {
+            err = m_lexer.skip_string();
+        } else if (c == '-' || lexer::is_int(c)) {
+            err = m_lexer.skip_number();
+        } else if (auto tok = m_lexer.lex_token(); !tok) {
+            err = std::move(tok).error();
+        } else if (std::holds_alternative<symbol>(tok->tok)) {
+            err = json::error(tok->line, tok->col, "Parser Error: Unexpected token " + to_string(*tok));
+        }
+        end_skip();
+        return err;
+    }
+
+    // Reads `"key" :` and passes the key on
+    auto parse_key() noexcept -> std::optional<json::error> {
+        if (!m_lexer.skip_whitespace()) {
+            return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input, expecting key");
+        }
+        if (m_lexer.peek() != '"') {
+            return m_lexer.unexpected_token("Parser Error: Invalid object key '", "', expecting string.");
+        }
+        if (skipping()) {
+            if (auto err = m_lexer.skip_string()) {
+                return err;
+            }
+        } else {
+            auto key = m_lexer.lex_string_view(m_scratch);
+            if (!key) {
+                return std::move(key).error();
+            }
+            if (!m_handler.on_key(*key)) {
+                return stopped();
+            }
+        }
+        if (!m_lexer.skip_whitespace()) {
+            return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input, expecting ':'");
+        }
+        if (m_lexer.peek() != ':') {
+            return m_lexer.unexpected_token("Parser Error: Unexpected token '", "' expected ':'");
+        }
+        m_lexer.advance();
+        return std::nullopt;
+    }
+
+    auto close_aggregate() noexcept -> bool {
+        const auto close = m_stack.back();
+        m_stack.pop_back();
+        if (skipping()) {
+            end_skip();
+            return true;
+        }
+        return close == ']' ? m_handler.end_array() : m_handler.end_object();
+    }
+
+    [[nodiscard]] auto skipping() const noexcept -> bool {
+        if constexpr (skipping_handler<Handler>) {
+            return m_skip != 0;
+        } else {
+            return false;
+        }
+    }
+
+    // Called as each value inside a skipped one finishes; events resume after the skipped value
+    void end_skip() noexcept {
+        if (m_skip == m_stack.size() + 1) {
+            m_skip = 0;
+        }
+    }
+
+    auto carry_on(bool handled) const noexcept -> std::optional<json::error> {
+        if (handled) {
+            return std::nullopt;
+        }
+        return stopped();
+    }
+
+    auto stopped() const noexcept -> json::error {
+        return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Stopped by handler");
+    }
+
+    lexer m_lexer;
+    Handler& m_handler;
+    parse_options m_options;
+    std::vector<char> m_stack;
+    std::string m_scratch;
+    // One more than the depth of the value being skipped, or 0
+    std::size_t m_skip = 0;
+};
+
+// Builds a value from parse events. Open arrays and objects wait on an explicit stack until their
+// end event hands them to their parent. Every string and aggregate is created with the given
+// allocator.
+template <class Value>
+struct dom_builder {
+    using allocator_type = typename Value::allocator_type;
+    using array_type = typename Value::array_type;
+    using object_type = typename Value::object_type;
+    using string_type = typename Value::string_type;
+
+    // View strings need the text being parsed, so those that were decoded can be told apart
+    explicit dom_builder(const allocator_type& alloc = {}, std::string_view source = {}) noexcept
+    : m_alloc(alloc), m_source(source) {}
+
+    auto on_null() -> bool {
+        return add(Value());
+    }
+
+    auto on_bool(bool b) -> bool {
+        return add(Value(b));
+    }
+
+    auto on_int(std::int64_t i) -> bool {
+        return add(Value(i));
+    }
+
+    auto on_double(double d) -> bool {
+        return add(Value(d));
+    }
+
+    auto on_string(std::string_view s) -> bool {
+        return add(Value(new_string(s)));
+    }
+
+    auto on_key(std::string_view s) -> bool {
+        m_stack.back().key = new_string(s);
+        return true;
+    }
+
+    auto start_object() -> bool {
+        m_stack.emplace_back(std::in_place_type<object_type>, m_alloc);
+        return true;
+    }
+
+    auto start_array() -> bool {
+        m_stack.emplace_back(std::in_place_type<array_type>, m_alloc);
+        return true;
+    }
+
+    auto end_object() -> bool {
+        return add(pop());
+    }
+
+    auto end_array() -> bool {
+        return add(pop());
+    }
+
+    auto take() noexcept -> Value {
+        return std::move(m_root);
+    }
+
+private:
+    // An array or object still being filled, with the key of the member being parsed
+    struct frame {
+        template <class Aggregate>
+        frame(std::in_place_type_t<Aggregate> type, const allocator_type& alloc) : aggregate(type, alloc), key(new_string({}, alloc)) {}
+
+        std::variant<array_type, object_type> aggregate;
+        string_type key;
+    };
+
+    static auto new_string(std::string_view s, const allocator_type& alloc) -> string_type {
+        if constexpr (std::constructible_from<string_type, std::string_view, const allocator_type&>) {
+            return string_type(s, alloc);
+        } else {
+            return string_type(s);
+        }
+    }
+
+    auto new_string(std::string_view s) const -> string_type {
+        if constexpr (std::same_as<string_type, std::string_view>) {
+            // Views of the source can be kept as they are; strings decoded from escapes are only
+            // valid until the next event, so they are copied into the arena
+            const auto less = std::less<const char*>();
+            const auto source_end = m_source.data() + m_source.size();
+            if (less(s.data(), m_source.data()) || less(source_end, s.data() + s.size())) {
+                auto p = static_cast<char*>(allocator_type(m_alloc).allocate_bytes(s.size(), 1));
+                std::memcpy(p, s.data(), s.size());
+                return string_type(p, s.size());
+            }
+            return s;
+        } else {
+            return new_string(s, m_alloc);
+        }
+    }
+
+    auto add(Value&& val) -> bool {
+        if (m_stack.empty()) {
+            m_root = std::move(val);
+            return true;
+        }
+        auto& top = m_stack.back();
+        if (auto arr = std::get_if<array_type>(&top.aggregate)) {
+            arr->push_back(std::move(val));
+        } else {
+            std::get<object_type>(top.aggregate).insert(std::pair(std::move(top.key), std::move(val)));
+        }
+        return true;
+    }
+
+    auto pop() -> Value {
+        auto val = std::visit([](auto& aggregate) { return Value(std::move(aggregate)); }, m_stack.back().aggregate);
+        m_stack.pop_back();
+        return val;
+    }
+
+    [[no_unique_address]] allocator_type m_alloc;
+    std::string_view m_source;
+    std::vector<frame> m_stack;
+    Value m_root;
+};
+
+}
+
+// Parses `s`, reporting each value to `handler` instead of building a tree. Events are dispatched
+// statically, so a handler that only counts or sums costs no more than the lexing itself. Returns
+// the first syntax error, or the position at which the handler asked to stop.
+template <sax_handler Handler>
+auto parse_sax(std::string_view s, Handler& handler, const parse_options& options = {}) noexcept -> std::optional<error> {
+    if (s.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return detail::sax_parser<Handler>(detail::lexer(s), handler, options).parse();
+    }
+    const auto index = detail::index_structurals(s);
+    return detail::sax_parser<Handler>(detail::lexer(s, index), handler, options).parse();
+}
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef JSON_SERIALIZER_HPP
+#define JSON_SERIALIZER_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mee::json {
+
+template <class>
+struct is_value;
+
+namespace detail {
+
+// Appends `s` quoted, escaping quotes, backslashes and control characters. Other bytes,
+// including UTF-8 sequences, are copied as they are.
+void dump_string(std::string_view s, std::string& out);
+
+void dump_int(std::int64_t i, std::string& out);
+
+// JSON has no NaN or infinity, so those are written as null
+void dump_float(double d, std::string& out);
+
+template <class Value>
+void dump_value(const Value& v, std::string& out);
+
+template <class Array>
+void dump_array(const Array& arr, std::string& out) {
+    out += '[';
+    auto first = true;
+    for (const auto& val : arr) {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+        dump_value(val, out);
+    }
+    out += ']';
+}
+
+template <class Object>
+void dump_object(const Object& obj, std::string& out) {
+    out += '{';
+    auto first = true;
+    for (const auto& member : obj) {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+        dump_string(std::string_view(member.first()), out);
+        out += ':';
+        dump_value(member.second(), out);
+    }
+    out += '}';
+}
+
+template <class Value>
+void dump_value(const Value& v, std::string& out) {
+    visit([&out]<class T>(const T& x) {
+        if constexpr (std::same_as<T, typename Value::null_type>) {
+            out += "null";
+        } else if constexpr (std::same_as<T, typename Value::bool_type>) {
+            out += x ? std::string_view("true") : std::string_view("false");
+        } else if constexpr (std::same_as<T, typename Value::int_type>) {
+            dump_int(std::int64_t(x), out);
+        } else if constexpr (std::same_as<T, typename Value::float_type>) {
+            dump_float(double(x), out);
+        } else if constexpr (std::same_as<T, typename Value::string_type>) {
+            dump_string(std::string_view(x), out);
+        } else if constexpr (std::same_as<T, typename Value::array_type>) {
+            dump_array(x, out);
+        } else {
+            dump_object(x, out);
+        }
+    }, v);
+}
+
+}
+
+// Appends the compact JSON text of `v` to `out`, reusing whatever capacity it already has
+template <class Value> requires is_value<Value>::value
+void dump(const Value& v, std::string& out) {
+    detail::dump_value(v, out);
+}
+
+template <class Value> requires is_value<Value>::value
+auto dump(const Value& v) -> std::string {
+    auto out = std::string();
+    detail::dump_value(v, out);
+    return out;
+}
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef JSON_STREAM_HPP
+#define JSON_STREAM_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "parser.hpp"
+
+namespace mee::json {
+
+struct parse_many_options {
+    parse_options parse = {};
+    // Threads parsing batches while the calling thread hands out results; 0 for one per core
+    std::size_t threads = 0;
+    // Roughly how many bytes of input each batch holds. Batches end at a line break, so a batch
+    // always holds whole lines.
+    std::size_t batch_size = std::size_t(1) << 16;
+};
+
+// Parses input holding any number of values one after another, be it newline delimited JSON or
+// documents simply written back to back. The input is cut into batches at line breaks, which never
+// appear inside a JSON string, and the batches are parsed on several threads. Each batch is parsed
+// on the guess that a value starts where it does; a value spanning lines that runs into the next
+// batch proves that batch's guess wrong, and it is parsed again from where the value ended.
+//
+// `handler` is called on the calling thread with each value, in order, and returns whether to
+// carry on. A malformed value is passed on as its error, with its line counted from the start of
+// the input, and parsing picks up again at the next line.
+void parse_many(std::string_view, const std::function<bool(result<value>&&)>& handler, const parse_many_options& = {});
+
+// Every value in the input, in order
+auto parse_many(std::string_view, const parse_many_options& = {}) -> std::vector<result<value>>;
+
+}
+
+#endif
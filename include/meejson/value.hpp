@@ -2,17 +2,21 @@
 #define JSON_VALUE_HPP
 
 #include <variant>
+#include <cstddef>
 #include <type_traits>
 #include <string>
 #include <cstdint>
 #include <functional>
 #include <concepts>
-#include <string>
+#include <limits>
+#include <optional>
+#include <utility>
 
 #include "box.hpp"
 #include "array.hpp"
 #include "object.hpp"
 #include "except.hpp"
+#include "serializer.hpp"
 #include "detail.hpp"
 #include "type_list.hpp"
 
@@ -54,6 +58,39 @@ private:
     T* m_ptr;
 };
 
+// Why a value couldn't be read as a type, without a message to build
+enum class access_error {
+    wrong_type,
+    out_of_range
+};
+
+// The value a conversion produced, or why there wasn't one
+template <class T>
+struct access_result {
+    constexpr explicit(false) access_result(T val) noexcept : m_val(val), m_err() {}
+    constexpr explicit(false) access_result(access_error err) noexcept : m_val(), m_err(err) {}
+
+    constexpr explicit operator bool() const noexcept {
+        return !m_err;
+    }
+
+    constexpr auto operator*() const noexcept -> T {
+        return m_val;
+    }
+
+    [[nodiscard]] constexpr auto error() const noexcept -> access_error {
+        return *m_err;
+    }
+
+    [[nodiscard]] constexpr auto value_or(T other) const noexcept -> T {
+        return m_err ? other : m_val;
+    }
+
+private:
+    T m_val;
+    std::optional<access_error> m_err;
+};
+
 struct null {
     constexpr auto operator<=>(const null&) const noexcept -> std::strong_ordering = default;
 };
@@ -174,13 +211,15 @@ template <class IntType = std::int64_t,
           class FloatType = double,
           class StringType = std::string,
           template <class> class ArrayType = basic_array,
-          template <class> class ObjectType = basic_object>
+          template <class> class ObjectType = basic_object,
+          class Allocator = std::allocator<std::byte>>
 struct value_args {
     type_t<IntType> int_type{};
     type_t<FloatType> float_type{};
     type_t<StringType> string_type{};
     templ_t<ArrayType> array_type{};
     templ_t<ObjectType> object_type{};
+    type_t<Allocator> allocator_type{};
 
     constexpr auto operator==(const value_args&) const noexcept -> bool = default;
 };
@@ -189,7 +228,8 @@ template <class IntType = std::int64_t,
     class FloatType = double,
     class StringType = std::string,
     template <class> class ArrayType = basic_array,
-    template <class> class ObjectType = basic_object>
+    template <class> class ObjectType = basic_object,
+    class Allocator = std::allocator<std::byte>>
 struct basic_value {
 #if 0
     constexpr static auto args = Args;
@@ -201,6 +241,7 @@ struct basic_value {
     using string_type = typename decltype(Args.string_type)::type;
     using array_type = typename decltype(Args.array_type)::template templ<basic_value>;
     using object_type = typename decltype(Args.object_type)::template templ<basic_value>;
+    using allocator_type = typename decltype(Args.allocator_type)::type;
 #endif
 
     using null_type = null;
@@ -210,28 +251,48 @@ struct basic_value {
     using string_type = StringType;
     using array_type = ArrayType<basic_value>;
     using object_type = ObjectType<basic_value>;
+    // Arrays and objects are boxed with this allocator, and the default containers use it for their elements
+    using allocator_type = Allocator;
     using numbers = type_list<int_type, float_type>;
     using primitives = type_list<null_type, bool_type, int_type, float_type, string_type>;
     using aggregates = type_list<array_type, object_type>;
     using types = type_list<null_type, bool_type, int_type, float_type, string_type, array_type, object_type>;
-    using value_type = std::variant<null_type, bool_type, int_type, float_type, string_type, detail::box<array_type>, detail::box<object_type>>;
+    template <class T>
+    using box_type = detail::box<T, detail::rebind_alloc<allocator_type, T>>;
+    using value_type = std::variant<null_type, bool_type, int_type, float_type, string_type, box_type<array_type>, box_type<object_type>>;
 
     template <class T> requires in_type_list<T, types>
     constexpr static auto type_name_v = type_name<basic_value, T>::value;
 
     constexpr basic_value() noexcept : m_val() {}
     basic_value(const basic_value& other) : m_val(std::visit(detail::overload{
-        []<class T>(const detail::box<T>& val) { return value_type(val.clone()); },
+        []<class T, class A>(const detail::box<T, A>& val) { return value_type(val.clone()); },
         [](const auto& val) { return value_type(val); },
     }, other.m_val)) {}
 
     constexpr basic_value(basic_value&& other) noexcept : m_val(std::move(other.m_val)) {}
 
+    // Tears nested aggregates down one level at a time rather than recursing once per level. Detached
+    // aggregates wait on a list threaded through their own first slot, so nothing is allocated.
+    ~basic_value() {
+        if (!is_nested()) {
+            return;
+        }
+        auto pending = basic_value();
+        detach_children(pending);
+        while (pending.is_nested()) {
+            auto val = std::move(pending);
+            pending = std::move(val.first_child());
+            val.detach_children(pending);
+            val.m_val = null_type();
+        }
+    }
+
     template <class T> requires in_type_list<std::remove_cvref_t<T>, primitives>
     constexpr explicit basic_value(T&& t) noexcept : m_val(std::forward<T>(t)) {}
 
     template <class T> requires in_type_list<std::remove_cvref_t<T>, aggregates>
-    constexpr explicit basic_value(T&& t) noexcept : m_val(detail::make_box<std::remove_cvref_t<T>>(std::forward<T>(t))) {}
+    constexpr explicit basic_value(T&& t) noexcept : m_val(box_aggregate(std::forward<T>(t))) {}
 
     template <json::integral Int> requires (!std::same_as<Int, int_type>)
     constexpr explicit basic_value(Int i) noexcept : m_val(int_type(i)) {}
@@ -242,12 +303,17 @@ struct basic_value {
     template <class S> requires (!std::same_as<std::remove_cvref_t<S>, string_type> && std::constructible_from<string_type, S>)
     constexpr explicit basic_value(S&& s) noexcept : m_val(string_type(std::forward<S>(s))) {}
 
-    constexpr basic_value(std::initializer_list<basic_value> list) : m_val(detail::make_box<array_type>(list)) {}
-    constexpr basic_value(std::initializer_list<std::pair<const string_type, basic_value>> list) : m_val(detail::make_box<object_type>(list)) {}
+    // Lets std::pmr containers, which construct through uses-allocator construction, hold values
+    // directly. As with boxes, the value keeps whatever its parts were allocated with.
+    template <class... Args> requires std::constructible_from<basic_value, Args...>
+    basic_value(std::allocator_arg_t, const allocator_type&, Args&&... args) : basic_value(std::forward<Args>(args)...) {}
+
+    constexpr basic_value(std::initializer_list<basic_value> list) : m_val(detail::allocate_box<array_type>(allocator_type(), list)) {}
+    constexpr basic_value(std::initializer_list<std::pair<const string_type, basic_value>> list) : m_val(detail::allocate_box<object_type>(allocator_type(), list)) {}
 
     auto operator=(const basic_value& other) -> basic_value& {
         m_val = std::visit(detail::overload{
-            []<class T>(const detail::box<T>& val) { return value_type(val.clone()); },
+            []<class T, class A>(const detail::box<T, A>& val) { return value_type(val.clone()); },
             [](const auto& val) { return value_type(val); },
         }, other.m_val);
         return *this;
@@ -260,7 +326,7 @@ struct basic_value {
         if constexpr (in_type_list<std::remove_cvref_t<T>, primitives>) {
             m_val = std::forward<T>(t);
         } else {
-            m_val = detail::make_box<std::remove_cvref_t<T>>(std::forward<T>(t));
+            m_val = box_aggregate(std::forward<T>(t));
         }
         return *this;
     }
@@ -284,12 +350,12 @@ struct basic_value {
     }
 
     constexpr auto operator=(std::initializer_list<basic_value> list) noexcept -> basic_value& {
-        m_val = detail::make_box<array_type>(list);
+        m_val = detail::allocate_box<array_type>(allocator_type(), list);
         return *this;
     }
 
     constexpr auto operator=(std::initializer_list<std::pair<string_type, basic_value>> list) noexcept -> basic_value& {
-        m_val = detail::make_box<object_type>(list);
+        m_val = detail::allocate_box<object_type>(allocator_type(), list);
         return *this;
     }
 
@@ -300,7 +366,7 @@ struct basic_value {
     template <class T> requires in_type_list<T, types>
     constexpr auto get() -> T& {
         if constexpr (in_type_list<T, aggregates>) {
-            return *std::get<detail::box<T>>(m_val);
+            return *std::get<box_type<T>>(m_val);
         } else {
             return std::get<T>(m_val);
         }
@@ -309,7 +375,7 @@ struct basic_value {
     template <class T> requires in_type_list<T, types>
     constexpr auto get() const -> const T& {
         if constexpr (in_type_list<T, aggregates>) {
-            return *std::get<detail::box<T>>(m_val);
+            return *std::get<box_type<T>>(m_val);
         } else {
             return std::get<T>(m_val);
         }
@@ -332,7 +398,7 @@ struct basic_value {
 
     template <class T> requires in_type_list<T, aggregates>
     [[nodiscard]] constexpr auto holds() const noexcept -> bool {
-        return std::holds_alternative<detail::box<T>>(m_val);
+        return std::holds_alternative<box_type<T>>(m_val);
     }
 
     template <class F, class Value> requires is_value<Value>::value && visitable<F, typename Value::types>
@@ -342,11 +408,11 @@ struct basic_value {
     constexpr friend auto visit(F&& f, const Value& v1, const Value& v2);
 
     auto has_key(std::string_view s) const -> bool {
-        auto obj = get_if<object_type>();
-        if (!obj) {
-            throw invalid_operation(type_name(), "has_key");
-        }
-        return obj->contains(s);
+        return has_key_impl(s);
+    }
+
+    auto has_key(const hashed_key& k) const -> bool {
+        return has_key_impl(k);
     }
 
     template <class T> requires std::constructible_from<basic_value, T>
@@ -364,34 +430,25 @@ struct basic_value {
         if (!obj) {
             throw invalid_operation(type_name(), "object emplace");
         }
-        return *obj->emplace(key, std::forward<T>(val)).second();
+        return obj->emplace(string_type(key), std::forward<T>(val)).first->second();
     }
 
 
+    // Lookups search the object by view, so no key is built
     auto operator[](std::string_view s) -> basic_value& {
-        auto obj = get_if<object_type>();
-        if (!obj) {
-            throw invalid_operation(type_name(), "[string]");
-        }
-        auto iter = obj->find(s);
-        if (iter != obj->end()) {
-            return iter->second();
-        } else {
-            throw invalid_access(s);
-        }
+        return member(*this, s);
     }
 
     auto operator[](std::string_view s) const -> const basic_value& {
-        auto obj = get_if<object_type>();
-        if (!obj) {
-            throw invalid_operation(type_name(), "[string]");
-        }
-        auto iter = obj->find(s);
-        if (iter != obj->end()) {
-            return iter->second();
-        } else {
-            throw invalid_access(s);
-        }
+        return member(*this, s);
+    }
+
+    auto operator[](const hashed_key& k) -> basic_value& {
+        return member(*this, k);
+    }
+
+    auto operator[](const hashed_key& k) const -> const basic_value& {
+        return member(*this, k);
     }
 
     auto operator[](std::size_t i) -> basic_value& {
@@ -418,6 +475,86 @@ struct basic_value {
         }
     }
 
+    // Unlike operator[], these return nullptr for a missing member or element, or for a value that
+    // isn't an object or array, and never throw or allocate
+    auto find(std::string_view s) noexcept -> optional_ref<basic_value> {
+        return find_child(*this, s);
+    }
+
+    auto find(std::string_view s) const noexcept -> optional_ref<const basic_value> {
+        return find_child(*this, s);
+    }
+
+    auto find(const hashed_key& k) noexcept -> optional_ref<basic_value> {
+        return find_child(*this, k);
+    }
+
+    auto find(const hashed_key& k) const noexcept -> optional_ref<const basic_value> {
+        return find_child(*this, k);
+    }
+
+    auto find(std::size_t i) noexcept -> optional_ref<basic_value> {
+        return find_child(*this, i);
+    }
+
+    auto find(std::size_t i) const noexcept -> optional_ref<const basic_value> {
+        return find_child(*this, i);
+    }
+
+    // Follows member names, hashed keys and indices in turn, as in v.at_path("items", 0, "id")
+    template <class... Keys>
+    auto at_path(const Keys&... keys) noexcept -> optional_ref<basic_value> {
+        auto p = optional_ref<basic_value>(this);
+        ((p = p ? p->find(keys) : nullptr), ...);
+        return p;
+    }
+
+    template <class... Keys>
+    auto at_path(const Keys&... keys) const noexcept -> optional_ref<const basic_value> {
+        auto p = optional_ref<const basic_value>(this);
+        ((p = p ? p->find(keys) : nullptr), ...);
+        return p;
+    }
+
+    // Reads a bool, a number or a string view. Integers convert to floating point, but floats never
+    // convert to integers, and an integer that doesn't fit T is out of range.
+    template <class T> requires std::same_as<T, bool> || arithmetic<T> || std::same_as<T, std::string_view>
+    constexpr auto as() const noexcept -> access_result<T> {
+        if constexpr (std::same_as<T, bool>) {
+            if (auto b = get_if<bool_type>()) {
+                return bool(*b);
+            }
+        } else if constexpr (integral<T>) {
+            if (auto i = get_if<int_type>()) {
+                if (!std::in_range<T>(*i)) {
+                    return access_error::out_of_range;
+                }
+                return T(*i);
+            }
+        } else if constexpr (std::floating_point<T>) {
+            if (auto f = get_if<float_type>()) {
+                return T(*f);
+            }
+            if (auto i = get_if<int_type>()) {
+                return T(*i);
+            }
+        } else {
+            if (auto str = get_if<string_type>()) {
+                return std::string_view(*str);
+            }
+        }
+        return access_error::wrong_type;
+    }
+
+    // The member or element as T, or `other` when it is missing or isn't a T. A string literal
+    // default reads the member as a std::string_view.
+    template <class K, class T>
+    auto get_or(const K& key, T other) const noexcept {
+        using R = std::conditional_t<std::same_as<T, const char*>, std::string_view, T>;
+        const auto v = find(key);
+        return v ? v->template as<R>().value_or(R(other)) : R(other);
+    }
+
     auto operator+=(const basic_value& other) -> basic_value& {
         detail::apply_value_assign(*this, other, std::plus(), "+=");
         return *this;
@@ -609,7 +746,7 @@ struct basic_value {
     }
 
     constexpr auto get_bool() noexcept -> bool_type& {
-        return get<float_type>();
+        return get<bool_type>();
     }
 
     constexpr auto get_bool() const noexcept -> const bool_type& {
@@ -665,7 +802,7 @@ struct basic_value {
     }
 
     constexpr auto get_if_bool() noexcept -> optional_ref<bool_type> {
-        return get_if<float_type>();
+        return get_if<bool_type>();
     }
 
     constexpr auto get_if_bool() const noexcept -> optional_ref<const bool_type> {
@@ -713,6 +850,100 @@ struct basic_value {
     }
 
 private:
+    // An aggregate moved in is boxed with its own allocator, so it stays next to its elements. Copies
+    // start from a default allocator, like a container copy would.
+    template <class T>
+    static auto box_aggregate(T&& t) -> value_type {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (std::is_rvalue_reference_v<T&&> && requires { t.get_allocator(); }) {
+            return detail::allocate_box<U>(t.get_allocator(), std::move(t));
+        } else {
+            return detail::allocate_box<U>(allocator_type(), std::forward<T>(t));
+        }
+    }
+
+    // Whether this is an array or object with at least one element
+    [[nodiscard]] auto is_nested() const noexcept -> bool {
+        if (auto arr = std::get_if<box_type<array_type>>(&m_val)) {
+            return *arr && !(*arr)->empty();
+        } else if (auto obj = std::get_if<box_type<object_type>>(&m_val)) {
+            return *obj && !(*obj)->empty();
+        }
+        return false;
+    }
+
+    // Only called on a nested value
+    auto first_child() noexcept -> basic_value& {
+        if (auto arr = std::get_if<box_type<array_type>>(&m_val)) {
+            return *(*arr)->begin();
+        }
+        return std::get<box_type<object_type>>(m_val)->begin()->second();
+    }
+
+    // Moves every nested element onto the pending list. Each one detached keeps the list so far in
+    // its first slot, and whatever that slot held is detached in turn.
+    auto detach_children(basic_value& pending) noexcept -> void {
+        const auto detach = [&pending](basic_value& child) {
+            while (child.is_nested()) {
+                auto val = std::move(child);
+                auto first = std::move(val.first_child());
+                val.first_child() = std::move(pending);
+                pending = std::move(val);
+                child = std::move(first);
+            }
+        };
+        if (auto arr = std::get_if<box_type<array_type>>(&m_val)) {
+            for (auto& child : **arr) {
+                detach(child);
+            }
+        } else {
+            for (auto&& member : *std::get<box_type<object_type>>(m_val)) {
+                detach(member.second());
+            }
+        }
+    }
+
+    template <class K>
+    auto has_key_impl(const K& k) const -> bool {
+        auto obj = get_if<object_type>();
+        if (!obj) {
+            throw invalid_operation(type_name(), "has_key");
+        }
+        return obj->contains(k);
+    }
+
+    template <class Self, class K>
+    static auto member(Self& self, const K& k) -> auto& {
+        auto obj = self.template get_if<object_type>();
+        if (!obj) {
+            throw invalid_operation(self.type_name(), "[string]");
+        }
+        auto iter = obj->find(k);
+        if (iter == obj->end()) {
+            if constexpr (std::same_as<K, hashed_key>) {
+                throw invalid_access(k.key);
+            } else {
+                throw invalid_access(k);
+            }
+        }
+        return iter->second();
+    }
+
+    template <class Self, class K>
+    static auto find_child(Self& self, const K& k) noexcept -> optional_ref<Self> {
+        if constexpr (std::same_as<K, std::size_t>) {
+            auto arr = self.template get_if<array_type>();
+            return arr && k < arr->size() ? &(*arr)[k] : nullptr;
+        } else {
+            auto obj = self.template get_if<object_type>();
+            if (!obj) {
+                return nullptr;
+            }
+            auto iter = obj->find(k);
+            return iter == obj->end() ? nullptr : &iter->second();
+        }
+    }
+
     value_type m_val;
 };
 
@@ -721,8 +952,8 @@ using value = basic_value<>;
 template <class V>
 struct is_value : std::false_type {};
 
-template <class I, class F, class S, template <class> class A, template <class> class O>
-struct is_value<basic_value<I, F, S, A, O>> : std::true_type {};
+template <class I, class F, class S, template <class> class A, template <class> class O, class Alloc>
+struct is_value<basic_value<I, F, S, A, O, Alloc>> : std::true_type {};
 
 template <class V>
 constexpr inline auto is_value_v = is_value<V>::value;
@@ -743,7 +974,7 @@ const auto& get(const Value& val) noexcept {
 template <class F, class Value> requires is_value<Value>::value && visitable<F, typename Value::types>
 constexpr auto visit(F&& f, const Value& v) {
     return std::visit(detail::overload{
-        [f = std::forward<F>(f)]<class T>(const detail::box<T>& b) { return f(*b); },
+        [f = std::forward<F>(f)]<class T, class A>(const detail::box<T, A>& b) { return f(*b); },
         [f = std::forward<F>(f)](const auto& val) {
             static_assert(in_type_list<std::remove_cvref_t<decltype(val)>, typename Value::types>);
             return f(val);
@@ -755,12 +986,12 @@ template <class F, class Value> requires is_value<Value>::value && visitable2<F,
 constexpr auto visit(F&& f, const Value& v1, const Value& v2) {
     using detail::box;
     return std::visit(detail::overload{
-        [f = std::forward<F>(f)]<class T, class U>(const box<T>& lhs, const box<U>& rhs) { return f(*lhs, *rhs); },
-        [f = std::forward<F>(f)]<class T>(const box<T>& lhs, const auto& rhs) {
+        [f = std::forward<F>(f)]<class T, class A, class U, class B>(const box<T, A>& lhs, const box<U, B>& rhs) { return f(*lhs, *rhs); },
+        [f = std::forward<F>(f)]<class T, class A>(const box<T, A>& lhs, const auto& rhs) {
             static_assert(in_type_list<std::remove_cvref_t<decltype(rhs)>, typename Value::types>);
             return f(*lhs, rhs);
         },
-        [f = std::forward<F>(f)]<class T>(const auto& lhs, const box<T>& rhs) {
+        [f = std::forward<F>(f)]<class T, class A>(const auto& lhs, const box<T, A>& rhs) {
             static_assert(in_type_list<std::remove_cvref_t<decltype(lhs)>, typename Value::types>);
             return f(lhs, *rhs);
         },
@@ -786,15 +1017,7 @@ void apply_value_assign(Value& self, T other, F&& f, std::string_view op) {
 
 template <class Value> requires is_value_v<Value>
 auto operator<<(std::ostream& os, const Value& v) noexcept -> std::ostream& {
-    auto p = os.precision(std::numeric_limits<double>::max_digits10);
-    auto b = os.flags(std::ios_base::boolalpha);
-    json::visit(json::detail::overload{
-        [&os](const std::string& s) { os << "\"" << s << "\""; },
-        [&os](const auto& val) { os << val; },
-    }, v);
-    os.precision(p);
-    os.flags(b);
-    return os;
+    return os << json::dump(v);
 }
 
 namespace detail {
@@ -964,6 +1187,11 @@ inline auto operator""_value(const char* s, std::size_t n) noexcept -> value {
     return value(std::string(s, n));
 }
 
+// An object key hashed at compile time, so looking it up skips hashing
+consteval auto operator""_key(const char* s, std::size_t n) noexcept -> hashed_key {
+    return hashed_key(std::string_view(s, n));
+}
+
 }
 
 }
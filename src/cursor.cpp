@@ -0,0 +1,436 @@
+#include "../include/meejson/cursor.hpp"
+#include "../include/meejson/except.hpp"
+
+namespace mee {
+
+namespace {
+
+using json::detail::lexer;
+
+constexpr auto is_scalar_start(char c) noexcept -> bool {
+    return c != '[' && c != '{' && c != '"';
+}
+
+}
+
+json::cursor::cursor(std::string_view text) noexcept : m_text(text), m_lexer(text), m_root(this, 0) {
+    while (m_root.m_offset < text.size() && lexer::is_whitespace(text[m_root.m_offset])) {
+        m_root.m_offset++;
+    }
+}
+
+auto json::cursor::root() -> cursor_value {
+    if (m_root.m_offset == m_text.size()) {
+        throw error_exception(error(1, 1, "Parser Error: Unable to parse empty string"));
+    }
+    return m_root;
+}
+
+auto json::cursor::operator[](std::string_view k) -> cursor_value {
+    static_cast<void>(root());
+    return m_root[k];
+}
+
+auto json::cursor::skip_whitespace(std::size_t offset, std::string_view msg) -> std::size_t {
+    while (offset < m_text.size() && lexer::is_whitespace(m_text[offset])) {
+        offset++;
+    }
+    if (offset == m_text.size()) {
+        fail(offset, msg);
+    }
+    return offset;
+}
+
+auto json::cursor::skip(std::size_t offset) -> std::size_t {
+    const auto c = at(offset);
+    if (c == '"') {
+        return skip_string(offset);
+    }
+    if (c != '[' && c != '{') {
+        while (offset < m_text.size() && !lexer::is_whitespace(m_text[offset]) && !lexer::is_structural(m_text[offset])) {
+            offset++;
+        }
+        return offset;
+    }
+    // Only brackets and strings matter here; whatever is between them is checked if it is read
+    auto depth = std::size_t(0);
+    while (offset < m_text.size()) {
+        switch (m_text[offset]) {
+            case '"':
+                offset = skip_string(offset);
+                continue;
+            case '[':
+            case '{':
+                depth++;
+                break;
+            case ']':
+            case '}':
+                if (--depth == 0) {
+                    return offset + 1;
+                }
+                break;
+            default:
+                break;
+        }
+        offset++;
+    }
+    fail(offset, "Parser Error: Unexpected end of input");
+}
+
+auto json::cursor::skip_string(std::size_t offset) -> std::size_t {
+    const auto last = m_text.data() + m_text.size();
+    auto p = m_text.data() + offset + 1;
+    while (true) {
+        p = detail::find_string_special(p, last);
+        if (p == last) {
+            fail(m_text.size(), "Unexpected end of input while parsing string");
+        }
+        if (*p == '"') {
+            return std::size_t(p + 1 - m_text.data());
+        }
+        // Step over the escaped character, or a control character for the lexer to reject if read
+        p += *p == '\\' ? 2 : 1;
+        if (p > last) {
+            fail(m_text.size(), "Unexpected end of input while parsing string");
+        }
+    }
+}
+
+auto json::cursor::first_element(std::size_t offset) -> std::size_t {
+    offset = skip_whitespace(offset + 1, "Parser Error: Unexpected end of input, expected value");
+    if (at(offset) == ']') {
+        return npos;
+    }
+    if (at(offset) != '[' && at(offset) != '{' && lexer::is_structural(at(offset))) {
+        unexpected(offset, "Parser Error: Unexpected token ", "");
+    }
+    return offset;
+}
+
+auto json::cursor::next_element(std::size_t offset) -> std::size_t {
+    offset = skip_whitespace(skip(offset), "Parser Error: Unexpected end of input");
+    if (at(offset) == ']') {
+        return npos;
+    }
+    if (at(offset) != ',') {
+        unexpected(offset, "Unexpected token '", "' Expected ','");
+    }
+    offset = skip_whitespace(offset + 1, "Parser Error: Unexpected end of input");
+    if (at(offset) != '[' && at(offset) != '{' && lexer::is_structural(at(offset))) {
+        unexpected(offset, "Parser Error: Unexpected token ", "");
+    }
+    return offset;
+}
+
+auto json::cursor::first_key(std::size_t offset) -> std::size_t {
+    offset = skip_whitespace(offset + 1, "Parser Error: Unexpected end of input, expected value");
+    if (at(offset) == '}') {
+        return npos;
+    }
+    if (at(offset) != '"') {
+        unexpected(offset, "Parser Error: Invalid object key '", "', expecting string.");
+    }
+    return offset;
+}
+
+auto json::cursor::next_key(std::size_t value) -> std::size_t {
+    auto offset = skip_whitespace(skip(value), "Parser Error: Unexpected end of input");
+    if (at(offset) == '}') {
+        return npos;
+    }
+    if (at(offset) != ',') {
+        unexpected(offset, "Unexpected token '", "' Expected ','");
+    }
+    offset = skip_whitespace(offset + 1, "Parser Error: Unexpected end of input, expecting key");
+    if (at(offset) != '"') {
+        unexpected(offset, "Parser Error: Invalid object key '", "', expecting string.");
+    }
+    return offset;
+}
+
+auto json::cursor::member_value(std::size_t key) -> std::size_t {
+    auto offset = skip_whitespace(skip_string(key), "Parser Error: Unexpected end of input, expecting ':'");
+    if (at(offset) != ':') {
+        unexpected(offset, "Parser Error: Unexpected token '", "' expected ':'");
+    }
+    offset = skip_whitespace(offset + 1, "Parser Error: Unexpected end of input");
+    if (at(offset) != '[' && at(offset) != '{' && lexer::is_structural(at(offset))) {
+        unexpected(offset, "Parser Error: Unexpected token ", "");
+    }
+    return offset;
+}
+
+auto json::cursor::scalar_at(std::size_t offset) -> detail::scalar {
+    if (auto scalar = detail::scan_scalar(m_text.data() + offset, m_text.data() + m_text.size())) {
+        return *scalar;
+    }
+    m_lexer.seek(offset);
+    auto tok = m_lexer.lex_token();
+    if (!tok) {
+        throw error_exception(tok.error());
+    }
+    throw error_exception(error(tok->line, tok->col, "Parser Error: Unexpected token " + detail::to_string(*tok)));
+}
+
+auto json::cursor::string_at(std::size_t offset, std::string& scratch) -> std::string_view {
+    m_lexer.seek(offset);
+    auto s = m_lexer.lex_string_view(scratch);
+    if (!s) {
+        throw error_exception(s.error());
+    }
+    return *s;
+}
+
+void json::cursor::unexpected(std::size_t offset, std::string_view prefix, std::string_view suffix) {
+    m_lexer.seek(offset);
+    throw error_exception(m_lexer.unexpected_token(prefix, suffix));
+}
+
+void json::cursor::fail(std::size_t offset, std::string_view msg) {
+    m_lexer.seek(offset);
+    throw error_exception(error(m_lexer.line(), m_lexer.col(), std::string(msg)));
+}
+
+auto json::cursor_value::first() const noexcept -> char {
+    return m_cursor->at(m_offset);
+}
+
+auto json::cursor_value::type_name() const -> std::string_view {
+    switch (first()) {
+        case '{':
+            return "object";
+        case '[':
+            return "array";
+        case '"':
+            return "string";
+        case 't':
+        case 'f':
+            return "boolean";
+        case 'n':
+            return "null";
+        default:
+            return std::holds_alternative<std::int64_t>(m_cursor->scalar_at(m_offset)) ? "integer" : "float";
+    }
+}
+
+auto json::cursor_value::is_null() const -> bool {
+    return first() == 'n' && std::holds_alternative<null>(m_cursor->scalar_at(m_offset));
+}
+
+auto json::cursor_value::get_bool() const -> bool {
+    if (auto b = get_if_bool()) {
+        return *b;
+    }
+    throw invalid_operation(type_name(), "get_bool");
+}
+
+auto json::cursor_value::get_int() const -> std::int64_t {
+    if (auto i = get_if_int()) {
+        return *i;
+    }
+    throw invalid_operation(type_name(), "get_int");
+}
+
+auto json::cursor_value::get_float() const -> double {
+    if (auto d = get_if_float()) {
+        return *d;
+    }
+    throw invalid_operation(type_name(), "get_float");
+}
+
+auto json::cursor_value::get_string() const -> std::string_view {
+    if (auto s = get_if_string()) {
+        return *s;
+    }
+    throw invalid_operation(type_name(), "get_string");
+}
+
+auto json::cursor_value::get_array() const -> cursor_array {
+    if (first() != '[') {
+        throw invalid_operation(type_name(), "get_array");
+    }
+    return cursor_array(m_cursor, m_offset);
+}
+
+auto json::cursor_value::get_object() const -> cursor_object {
+    if (first() != '{') {
+        throw invalid_operation(type_name(), "get_object");
+    }
+    return cursor_object(m_cursor, m_offset);
+}
+
+auto json::cursor_value::get_if_bool() const -> std::optional<bool> {
+    if (const auto c = first(); c != 't' && c != 'f') {
+        return std::nullopt;
+    }
+    return std::get<bool>(m_cursor->scalar_at(m_offset));
+}
+
+auto json::cursor_value::get_if_int() const -> std::optional<std::int64_t> {
+    if (!is_scalar_start(first())) {
+        return std::nullopt;
+    }
+    const auto scalar = m_cursor->scalar_at(m_offset);
+    if (auto i = std::get_if<std::int64_t>(&scalar)) {
+        return *i;
+    }
+    return std::nullopt;
+}
+
+auto json::cursor_value::get_if_float() const -> std::optional<double> {
+    if (!is_scalar_start(first())) {
+        return std::nullopt;
+    }
+    const auto scalar = m_cursor->scalar_at(m_offset);
+    if (auto d = std::get_if<double>(&scalar)) {
+        return *d;
+    }
+    return std::nullopt;
+}
+
+auto json::cursor_value::get_if_string() const -> std::optional<std::string_view> {
+    if (first() != '"') {
+        return std::nullopt;
+    }
+    return m_cursor->string_at(m_offset, m_cursor->m_scratch);
+}
+
+auto json::cursor_value::get_if_array() const -> std::optional<cursor_array> {
+    if (first() != '[') {
+        return std::nullopt;
+    }
+    return cursor_array(m_cursor, m_offset);
+}
+
+auto json::cursor_value::get_if_object() const -> std::optional<cursor_object> {
+    if (first() != '{') {
+        return std::nullopt;
+    }
+    return cursor_object(m_cursor, m_offset);
+}
+
+auto json::cursor_value::has_key(std::string_view k) const -> bool {
+    if (first() != '{') {
+        throw invalid_operation(type_name(), "has_key");
+    }
+    return cursor_object(m_cursor, m_offset).contains(k);
+}
+
+auto json::cursor_value::operator[](std::string_view k) const -> cursor_value {
+    if (first() != '{') {
+        throw invalid_operation(type_name(), "[string]");
+    }
+    const auto c = m_cursor;
+    const auto first_key = c->first_key(m_offset);
+    const auto start = m_found ? c->next_key(m_found) : first_key;
+    // From where the last lookup left off to the end, then from the start up to there
+    for (auto key = start; key != cursor::npos; key = c->next_key(c->member_value(key))) {
+        if (c->string_at(key, c->m_key_scratch) == k) {
+            m_found = c->member_value(key);
+            return cursor_value(c, m_found);
+        }
+    }
+    for (auto key = first_key; key != start; key = c->next_key(c->member_value(key))) {
+        if (c->string_at(key, c->m_key_scratch) == k) {
+            m_found = c->member_value(key);
+            return cursor_value(c, m_found);
+        }
+    }
+    throw invalid_access(k);
+}
+
+auto json::cursor_value::operator[](std::size_t i) const -> cursor_value {
+    if (first() != '[') {
+        throw invalid_operation(type_name(), "[index]");
+    }
+    return cursor_array(m_cursor, m_offset)[i];
+}
+
+auto json::cursor_value::source() const -> std::string_view {
+    return m_cursor->m_text.substr(m_offset, m_cursor->skip(m_offset) - m_offset);
+}
+
+auto json::cursor_array::iterator::operator++() -> iterator& {
+    m_offset = m_cursor->next_element(m_offset);
+    return *this;
+}
+
+auto json::cursor_array::begin() const -> iterator {
+    return iterator(m_cursor, m_cursor->first_element(m_offset));
+}
+
+auto json::cursor_array::end() const noexcept -> iterator {
+    return iterator(m_cursor, cursor::npos);
+}
+
+auto json::cursor_array::empty() const -> bool {
+    return begin() == end();
+}
+
+auto json::cursor_array::size() const -> std::size_t {
+    return std::size_t(std::distance(begin(), end()));
+}
+
+auto json::cursor_array::operator[](std::size_t i) const -> cursor_value {
+    auto it = begin();
+    for (auto n = i; n > 0 && it != end(); n--) {
+        ++it;
+    }
+    if (it == end()) {
+        throw invalid_access(std::to_string(i));
+    }
+    return *it;
+}
+
+auto json::cursor_member::first() const -> std::string_view {
+    return m_cursor->string_at(m_offset, m_cursor->m_key_scratch);
+}
+
+auto json::cursor_member::second() const -> cursor_value {
+    return cursor_value(m_cursor, m_cursor->member_value(m_offset));
+}
+
+auto json::cursor_object::iterator::operator++() -> iterator& {
+    m_offset = m_cursor->next_key(m_cursor->member_value(m_offset));
+    return *this;
+}
+
+auto json::cursor_object::begin() const -> iterator {
+    return iterator(m_cursor, m_cursor->first_key(m_offset));
+}
+
+auto json::cursor_object::end() const noexcept -> iterator {
+    return iterator(m_cursor, cursor::npos);
+}
+
+auto json::cursor_object::empty() const -> bool {
+    return begin() == end();
+}
+
+auto json::cursor_object::size() const -> std::size_t {
+    return std::size_t(std::distance(begin(), end()));
+}
+
+auto json::cursor_object::find(std::string_view k) const -> iterator {
+    const auto last = end();
+    for (auto it = begin(); it != last; ++it) {
+        if ((*it).first() == k) {
+            return it;
+        }
+    }
+    return last;
+}
+
+auto json::cursor_object::contains(std::string_view k) const -> bool {
+    return find(k) != end();
+}
+
+auto json::cursor_object::at(std::string_view k) const -> cursor_value {
+    const auto it = find(k);
+    if (it == end()) {
+        throw invalid_access(k);
+    }
+    return (*it).second();
+}
+
+}
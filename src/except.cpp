@@ -1,12 +1,10 @@
 #include "../include/meejson/except.hpp"
 #include <string_view>
-#include <sstream>
 
 namespace mee {
+// Messages are appended piece by piece, since a stream costs more than the throw on a hot path
 json::invalid_operation::invalid_operation(std::string_view lhs, std::string_view rhs, std::string_view op) {
-    std::stringstream s;
-    s << "Invalid Operation \"" << op << "\" for types \"" << lhs << "\" and \"" << rhs << "\"";
-    msg = s.str();
+    msg.append("Invalid Operation \"").append(op).append("\" for types \"").append(lhs).append("\" and \"").append(rhs).append("\"");
 }
 
 auto json::invalid_operation::what() const noexcept -> const char* {
@@ -14,21 +12,17 @@ auto json::invalid_operation::what() const noexcept -> const char* {
 }
 
 json::invalid_operation::invalid_operation(std::string_view v, std::string_view op) {
-    std::stringstream s;
-    s << "Invalid Operation \"" << op << "\" for type \"" << v << "\"";
-    msg = s.str();
+    msg.append("Invalid Operation \"").append(op).append("\" for type \"").append(v).append("\"");
 }
 
 auto json::error::what() const noexcept -> std::string {
-    std::stringstream ss;
-    ss << msg << " (" << line << ':' << col << ')';
-    return ss.str();
+    auto s = msg;
+    s.append(" (").append(std::to_string(line)).append(":").append(std::to_string(col)).append(")");
+    return s;
 }
 
 json::invalid_access::invalid_access(std::string_view item) {
-    std::stringstream s;
-    s << "Invalid Access with key \"" << item << "\"";
-    msg = s.str();
+    msg.append("Invalid Access with key \"").append(item).append("\"");
 }
 
 auto json::invalid_access::what() const noexcept -> const char* {
@@ -38,4 +32,4 @@ auto json::invalid_access::what() const noexcept -> const char* {
 auto json::error_exception::what() const noexcept -> const char* {
     return msg.c_str();
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,142 @@
+#include "../include/meejson/file.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MEEJSON_MMAP 1
+#endif
+
+namespace mee {
+
+namespace {
+
+auto file_error(std::string_view what, const std::filesystem::path& path, std::string_view reason = {}) -> json::error {
+    auto msg = "File Error: " + std::string(what) + " '" + path.string() + '\'';
+    if (!reason.empty()) {
+        msg += ": ";
+        msg += reason;
+    }
+    return json::error(0, 0, std::move(msg));
+}
+
+#ifdef MEEJSON_MMAP
+// Closes the descriptor once the mapping, which keeps its own reference to the file, is made
+struct descriptor {
+    int fd;
+
+    ~descriptor() {
+        ::close(fd);
+    }
+};
+#endif
+
+}
+
+json::mapped_file::mapped_file(mapped_file&& other) noexcept
+: m_data(other.m_data), m_size(other.m_size), m_mapped(other.m_mapped), m_buffer(std::move(other.m_buffer)) {
+    if (!m_mapped) {
+        m_data = m_buffer.data();
+    }
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_mapped = false;
+}
+
+auto json::mapped_file::operator=(mapped_file&& other) noexcept -> mapped_file& {
+    if (this != &other) {
+        release();
+        std::construct_at(this, std::move(other));
+    }
+    return *this;
+}
+
+json::mapped_file::~mapped_file() {
+    release();
+}
+
+void json::mapped_file::release() noexcept {
+#ifdef MEEJSON_MMAP
+    if (m_mapped) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_buffer.clear();
+}
+
+auto json::map_file(const std::filesystem::path& path) noexcept -> result<mapped_file> {
+    auto file = mapped_file();
+#ifdef MEEJSON_MMAP
+    const auto fd = descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd.fd < 0) {
+        return file_error("Unable to open", path, std::strerror(errno));
+    }
+    struct stat st{};
+    if (::fstat(fd.fd, &st) != 0) {
+        return file_error("Unable to read", path, std::strerror(errno));
+    }
+    // Empty files can't be mapped, and aren't worth it
+    if (st.st_size == 0) {
+        return file;
+    }
+    const auto size = std::size_t(st.st_size);
+    auto p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.fd, 0);
+    if (p != MAP_FAILED) {
+        // The parser reads front to back once, so the kernel can read ahead aggressively and drop
+        // pages behind it
+        ::madvise(p, size, MADV_SEQUENTIAL);
+        file.m_data = static_cast<const char*>(p);
+        file.m_size = size;
+        file.m_mapped = true;
+        return file;
+    }
+    // Not every file can be mapped, so fall back to reading it
+#endif
+    auto in = std::ifstream(path, std::ios::binary);
+    if (!in) {
+        return file_error("Unable to open", path);
+    }
+    file.m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (in.bad()) {
+        return file_error("Unable to read", path);
+    }
+    file.m_data = file.m_buffer.data();
+    file.m_size = file.m_buffer.size();
+    return file;
+}
+
+auto json::parse_file(const std::filesystem::path& path, const parse_options& options) noexcept -> result<value> {
+    auto file = map_file(path);
+    if (!file) {
+        return std::move(file).error();
+    }
+    return parse(std::string_view(*file), options);
+}
+
+auto json::parse_document_file(const std::filesystem::path& path, const parse_options& options) noexcept -> result<document> {
+    auto file = map_file(path);
+    if (!file) {
+        return std::move(file).error();
+    }
+    return parse_document(std::string_view(*file), options);
+}
+
+auto json::parse_view_document_file(const std::filesystem::path& path, const parse_options& options) noexcept -> result<view_document> {
+    auto file = map_file(path);
+    if (!file) {
+        return std::move(file).error();
+    }
+    auto source = std::make_shared<const mapped_file>(std::move(*file));
+    const auto s = std::string_view(*source);
+    return detail::parse_arena<view::value>(s, std::move(source), options);
+}
+
+}
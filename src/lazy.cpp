@@ -0,0 +1,399 @@
+#include "../include/meejson/lazy.hpp"
+#include "../include/meejson/sax.hpp"
+#include <functional>
+
+namespace mee {
+
+namespace {
+
+using json::detail::lexer;
+
+enum class expect {
+    value,
+    first_value,
+    first_key,
+    key,
+    colon,
+    comma,
+    done
+};
+
+constexpr auto is_scalar_start(char c) noexcept -> bool {
+    return c != '[' && c != '{' && c != '"';
+}
+
+}
+
+auto json::detail::check_structure(std::string_view s, const std::vector<std::uint32_t>& index, std::vector<std::uint32_t>& ends,
+                                   const parse_options& options) noexcept -> std::optional<error> {
+    auto lex = lexer(s);
+    auto unexpected = [&lex, &index](std::uint32_t pos, std::string_view prefix, std::string_view suffix) {
+        lex.seek(index[pos]);
+        return lex.unexpected_token(prefix, suffix);
+    };
+    auto open = std::vector<std::uint32_t>();
+    auto state = expect::value;
+    for (auto pos = std::uint32_t(0); pos < index.size(); pos++) {
+        const auto c = s[index[pos]];
+        switch (state) {
+            case expect::done:
+                return unexpected(pos, "Parser Error: Unexpected token ", "");
+            case expect::colon:
+                if (c != ':') {
+                    return unexpected(pos, "Parser Error: Unexpected token '", "' expected ':'");
+                }
+                state = expect::value;
+                continue;
+            case expect::comma: {
+                const auto is_object = s[index[open.back()]] == '{';
+                if (c == ',') {
+                    state = is_object ? expect::key : expect::value;
+                    continue;
+                }
+                if (c != (is_object ? '}' : ']')) {
+                    return unexpected(pos, "Unexpected token '", "' Expected ','");
+                }
+                break;
+            }
+            case expect::first_key:
+            case expect::key:
+                if (state == expect::first_key && c == '}') {
+                    break;
+                }
+                if (c != '"') {
+                    return unexpected(pos, "Parser Error: Invalid object key '", "', expecting string.");
+                }
+                state = expect::colon;
+                continue;
+            case expect::first_value:
+            case expect::value:
+                if (state == expect::first_value && c == ']') {
+                    break;
+                }
+                if (c == '[' || c == '{') {
+                    if (open.size() >= options.max_depth) {
+                        lex.seek(index[pos]);
+                        return json::detail::depth_exceeded(lex.line(), lex.col(), options.max_depth);
+                    }
+                    open.push_back(pos);
+                    state = c == '[' ? expect::first_value : expect::first_key;
+                    continue;
+                }
+                if (lexer::is_structural(c)) {
+                    return unexpected(pos, "Parser Error: Unexpected token ", "");
+                }
+                state = open.empty() ? expect::done : expect::comma;
+                continue;
+        }
+        // `c` closes the innermost aggregate
+        ends[open.back()] = pos;
+        open.pop_back();
+        state = open.empty() ? expect::done : expect::comma;
+    }
+
+    lex.seek(s.size());
+    switch (state) {
+        case expect::done:
+            return std::nullopt;
+        case expect::value:
+            if (open.empty()) {
+                return json::error(1, 1, "Parser Error: Unable to parse empty string");
+            }
+            break;
+        case expect::first_value:
+        case expect::first_key:
+            return json::error(lex.line(), lex.col(), "Parser Error: Unexpected end of input, expected value");
+        case expect::key:
+            return json::error(lex.line(), lex.col(), "Parser Error: Unexpected end of input, expecting key");
+        case expect::colon:
+            return json::error(lex.line(), lex.col(), "Parser Error: Unexpected end of input, expecting ':'");
+        default:
+            break;
+    }
+    return json::error(lex.line(), lex.col(), "Parser Error: Unexpected end of input");
+}
+
+auto json::parse_lazy(std::string_view s, const parse_options& options) noexcept -> result<lazy_document> {
+    if (s.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return json::error(1, 1, "Parser Error: Lazy documents are limited to 4 GiB");
+    }
+    auto index = detail::index_structurals(s);
+    auto ends = std::vector<std::uint32_t>(index.size());
+    if (auto err = detail::check_structure(s, index, ends, options)) {
+        return std::move(*err);
+    }
+    return lazy_document(s, std::move(index), std::move(ends));
+}
+
+auto json::lazy_document::string_at(std::uint32_t pos) const -> std::string_view {
+    if (auto it = m_decoded.find(pos); it != m_decoded.end()) {
+        return it->second;
+    }
+    const auto s = key_at(pos);
+    if (s.data() != m_scratch.data()) {
+        return s;
+    }
+    return m_decoded.try_emplace(pos, s).first->second;
+}
+
+auto json::lazy_document::key_at(std::uint32_t pos) const -> std::string_view {
+    auto lex = detail::lexer(m_text);
+    lex.seek(offset(pos));
+    auto s = lex.lex_string_view(m_scratch);
+    if (!s) {
+        throw error_exception(s.error());
+    }
+    return *s;
+}
+
+auto json::lazy_document::scalar_at(std::uint32_t pos) const -> detail::scalar {
+    if (auto scalar = detail::scan_scalar(m_text.data() + offset(pos), m_text.data() + m_text.size())) {
+        return *scalar;
+    }
+    // Only a malformed scalar needs the lexer, to say where and what is wrong
+    auto lex = detail::lexer(m_text);
+    lex.seek(offset(pos));
+    auto tok = lex.lex_token();
+    if (!tok) {
+        throw error_exception(tok.error());
+    }
+    throw error_exception(error(tok->line, tok->col, "Parser Error: Unexpected token " + detail::to_string(*tok)));
+}
+
+auto json::lazy_value::type_name() const -> std::string_view {
+    switch (m_doc->at(m_pos)) {
+        case '{':
+            return "object";
+        case '[':
+            return "array";
+        case '"':
+            return "string";
+        case 't':
+        case 'f':
+            return "boolean";
+        case 'n':
+            return "null";
+        default:
+            return std::holds_alternative<std::int64_t>(m_doc->scalar_at(m_pos)) ? "integer" : "float";
+    }
+}
+
+auto json::lazy_value::is_null() const -> bool {
+    return m_doc->at(m_pos) == 'n' && std::holds_alternative<null>(m_doc->scalar_at(m_pos));
+}
+
+auto json::lazy_value::get_bool() const -> bool {
+    if (auto b = get_if_bool()) {
+        return *b;
+    }
+    throw invalid_operation(type_name(), "get_bool");
+}
+
+auto json::lazy_value::get_int() const -> std::int64_t {
+    if (auto i = get_if_int()) {
+        return *i;
+    }
+    throw invalid_operation(type_name(), "get_int");
+}
+
+auto json::lazy_value::get_float() const -> double {
+    if (auto d = get_if_float()) {
+        return *d;
+    }
+    throw invalid_operation(type_name(), "get_float");
+}
+
+auto json::lazy_value::get_string() const -> std::string_view {
+    if (m_doc->at(m_pos) != '"') {
+        throw invalid_operation(type_name(), "get_string");
+    }
+    return m_doc->string_at(m_pos);
+}
+
+auto json::lazy_value::get_array() const -> lazy_array {
+    if (m_doc->at(m_pos) != '[') {
+        throw invalid_operation(type_name(), "get_array");
+    }
+    return lazy_array(m_doc, m_pos);
+}
+
+auto json::lazy_value::get_object() const -> lazy_object {
+    if (m_doc->at(m_pos) != '{') {
+        throw invalid_operation(type_name(), "get_object");
+    }
+    return lazy_object(m_doc, m_pos);
+}
+
+auto json::lazy_value::get_if_bool() const -> std::optional<bool> {
+    if (const auto c = m_doc->at(m_pos); c != 't' && c != 'f') {
+        return std::nullopt;
+    }
+    return std::get<bool>(m_doc->scalar_at(m_pos));
+}
+
+auto json::lazy_value::get_if_int() const -> std::optional<std::int64_t> {
+    if (!is_scalar_start(m_doc->at(m_pos))) {
+        return std::nullopt;
+    }
+    const auto scalar = m_doc->scalar_at(m_pos);
+    if (auto i = std::get_if<std::int64_t>(&scalar)) {
+        return *i;
+    }
+    return std::nullopt;
+}
+
+auto json::lazy_value::get_if_float() const -> std::optional<double> {
+    if (!is_scalar_start(m_doc->at(m_pos))) {
+        return std::nullopt;
+    }
+    const auto scalar = m_doc->scalar_at(m_pos);
+    if (auto d = std::get_if<double>(&scalar)) {
+        return *d;
+    }
+    return std::nullopt;
+}
+
+auto json::lazy_value::get_if_string() const -> std::optional<std::string_view> {
+    if (m_doc->at(m_pos) != '"') {
+        return std::nullopt;
+    }
+    return m_doc->string_at(m_pos);
+}
+
+auto json::lazy_value::get_if_array() const -> std::optional<lazy_array> {
+    if (m_doc->at(m_pos) != '[') {
+        return std::nullopt;
+    }
+    return lazy_array(m_doc, m_pos);
+}
+
+auto json::lazy_value::get_if_object() const -> std::optional<lazy_object> {
+    if (m_doc->at(m_pos) != '{') {
+        return std::nullopt;
+    }
+    return lazy_object(m_doc, m_pos);
+}
+
+auto json::lazy_value::has_key(std::string_view k) const -> bool {
+    if (m_doc->at(m_pos) != '{') {
+        throw invalid_operation(type_name(), "has_key");
+    }
+    return lazy_object(m_doc, m_pos).contains(k);
+}
+
+auto json::lazy_value::operator[](std::string_view k) const -> lazy_value {
+    if (m_doc->at(m_pos) != '{') {
+        throw invalid_operation(type_name(), "[string]");
+    }
+    return lazy_object(m_doc, m_pos).at(k);
+}
+
+auto json::lazy_value::operator[](std::size_t i) const -> lazy_value {
+    if (m_doc->at(m_pos) != '[') {
+        throw invalid_operation(type_name(), "[index]");
+    }
+    return lazy_array(m_doc, m_pos)[i];
+}
+
+auto json::lazy_value::source() const -> std::string_view {
+    const auto first = m_doc->offset(m_pos);
+    if (const auto c = m_doc->at(m_pos); c == '[' || c == '{') {
+        return m_doc->m_text.substr(first, m_doc->offset(m_doc->m_ends[m_pos]) + 1 - first);
+    }
+    // A scalar runs until the next structural character, less any whitespace before it
+    auto last = m_pos + 1 < m_doc->m_index.size() ? m_doc->offset(m_pos + 1) : m_doc->m_text.size();
+    while (last > first && lexer::is_whitespace(m_doc->m_text[last - 1])) {
+        last--;
+    }
+    return m_doc->m_text.substr(first, last - first);
+}
+
+auto json::lazy_value::to_value() const -> value {
+    auto val = parse(source());
+    if (!val) {
+        throw error_exception(val.error());
+    }
+    return std::move(*val);
+}
+
+auto json::lazy_array::iterator::operator++() -> iterator& {
+    m_pos = m_doc->next(m_pos);
+    return *this;
+}
+
+auto json::lazy_array::begin() const -> iterator {
+    return iterator(m_doc, m_pos + 1);
+}
+
+auto json::lazy_array::end() const -> iterator {
+    return iterator(m_doc, m_doc->m_ends[m_pos]);
+}
+
+auto json::lazy_array::empty() const -> bool {
+    return begin() == end();
+}
+
+auto json::lazy_array::size() const -> std::size_t {
+    return std::size_t(std::distance(begin(), end()));
+}
+
+auto json::lazy_array::operator[](std::size_t i) const -> lazy_value {
+    auto it = begin();
+    for (auto n = i; n > 0 && it != end(); n--) {
+        ++it;
+    }
+    if (it == end()) {
+        throw invalid_access(std::to_string(i));
+    }
+    return *it;
+}
+
+auto json::lazy_member::first() const -> std::string_view {
+    return m_doc->string_at(m_pos);
+}
+
+auto json::lazy_object::iterator::operator++() -> iterator& {
+    m_pos = m_doc->next(m_pos + 2);
+    return *this;
+}
+
+auto json::lazy_object::begin() const -> iterator {
+    return iterator(m_doc, m_pos + 1);
+}
+
+auto json::lazy_object::end() const -> iterator {
+    return iterator(m_doc, m_doc->m_ends[m_pos]);
+}
+
+auto json::lazy_object::empty() const -> bool {
+    return begin() == end();
+}
+
+auto json::lazy_object::size() const -> std::size_t {
+    return std::size_t(std::distance(begin(), end()));
+}
+
+auto json::lazy_object::find(std::string_view k) const -> iterator {
+    const auto last = end();
+    for (auto it = begin(); it != last; ++it) {
+        // Keys are compared where they were decoded, so scanning past escaped ones keeps nothing
+        if (m_doc->key_at(it.m_pos) == k) {
+            return it;
+        }
+    }
+    return last;
+}
+
+auto json::lazy_object::contains(std::string_view k) const -> bool {
+    return find(k) != end();
+}
+
+auto json::lazy_object::at(std::string_view k) const -> lazy_value {
+    const auto it = find(k);
+    if (it == end()) {
+        throw invalid_access(k);
+    }
+    return (*it).second();
+}
+
+}
@@ -1,6 +1,8 @@
 #include "../include/meejson/lexer.hpp"
+#include <algorithm>
 #include <array>
 #include <concepts>
+#include <cstring>
 using namespace std::literals;
 
 namespace mee {
@@ -96,260 +98,453 @@ private:
     T m_bytes[4];
 };
 
-struct Lexer {
-    Lexer(std::string_view::const_iterator begin, std::string_view::const_iterator end) : m_iter(begin), m_end(end) {}
+// Stands in for the string being decoded when a string is only being checked
+struct discard {
+    void append(const char*, const char*) noexcept {}
 
-    constexpr static auto is_int(char c) noexcept -> bool {
-        return c >= '0' && c <= '9';
+    auto operator+=(std::string_view) noexcept -> discard& {
+        return *this;
     }
 
-    constexpr static auto is_hex(char c) noexcept -> bool {
-        return is_int(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
-    }
+    void push_back(char) noexcept {}
+};
+
+}
 
-    constexpr static auto is_whitespace(char c) noexcept -> bool {
-        return c == 0x20 || c == 0x0A || c == 0x0D || c == 0x09;
+namespace json::detail {
+
+auto scan_scalar(const char* first, const char* last) noexcept -> std::optional<scalar> {
+    auto terminated = [last](const char* p) {
+        return p == last || lexer::is_whitespace(*p) || lexer::is_structural(*p);
+    };
+    auto literal = [&](std::string_view s) {
+        return std::size_t(last - first) >= s.size() && std::string_view(first, s.size()) == s && terminated(first + s.size());
+    };
+    switch (*first) {
+        case 'n':
+            return literal("null") ? std::optional<scalar>(null()) : std::nullopt;
+        case 't':
+            return literal("true") ? std::optional<scalar>(true) : std::nullopt;
+        case 'f':
+            return literal("false") ? std::optional<scalar>(false) : std::nullopt;
+        default:
+            break;
     }
+    const auto num = scan_number(first, last);
+    if (num.ec != std::errc() || !terminated(num.ptr)) {
+        return std::nullopt;
+    }
+    return std::visit([](auto x) { return scalar(x); }, num.value);
+}
+
+auto to_string(const json::token& t) noexcept -> std::string {
+    using json::symbol;
+    return std::visit(overload{
+    [](symbol t) {
+        switch (t) {
+            case symbol::lbracket:
+                return "["s;
+            case symbol::rbracket:
+                return "]"s;
+            case symbol::lbrace:
+                return "{"s;
+            case symbol::rbrace:
+                return "}"s;
+            case symbol::colon:
+                return ":"s;
+            case symbol::comma:
+                return ","s;
+        };
+        std::terminate();
+    },
+    [](const std::string& s) { return '"' + s + '"'; },
+    [](json::null) { return "null"s; },
+    [](bool b) { return b ? "true"s : "false"s; },
+    [](const auto& x) { return std::to_string(x); }
+    }, t.tok);
+}
 
-    constexpr static auto is_alpha(char c) noexcept -> bool {
-        return c >= 'a' && c <= 'z';
+auto lexer::position(iterator it) const noexcept -> std::pair<std::int32_t, std::int32_t> {
+    if (it < m_pos_iter) {
+        m_pos_iter = m_begin;
+        m_line_begin = m_begin;
+        m_line = 1;
+    }
+    while (m_pos_iter != it) {
+        auto p = static_cast<iterator>(std::memchr(m_pos_iter, '\n', std::size_t(it - m_pos_iter)));
+        if (!p) {
+            break;
+        }
+        m_line++;
+        m_pos_iter = p + 1;
+        m_line_begin = m_pos_iter;
     }
+    m_pos_iter = it;
+    return {m_line, std::int32_t(it - m_line_begin) + 1};
+}
 
-    constexpr static auto is_exponent(char c) noexcept -> bool {
-        return c == 'e' || c == 'E';
+auto lexer::error_at(iterator it, std::string msg) const noexcept -> json::error {
+    auto [line, col] = position(it);
+    return json::error(line, col, std::move(msg));
+}
+
+auto lexer::check_terminated(iterator start) const noexcept -> std::optional<json::error> {
+    if (m_iter == m_end || is_whitespace(*m_iter) || is_structural(*m_iter)) {
+        return std::nullopt;
     }
+    auto end = m_iter;
+    while (end != m_end && !is_whitespace(*end) && !is_structural(*end)) {
+        end++;
+    }
+    return error_at(start, "Lexer Error: Unexpected Token \""s + std::string(start, end) + '"');
+}
 
-    void advance() noexcept {
+auto lexer::skip_whitespace() noexcept -> bool {
+    if (m_index) {
+        const auto offset = std::uint32_t(m_iter - m_begin);
+        while (m_index != m_index_end && *m_index < offset) {
+            m_index++;
+        }
+        if (m_index == m_index_end) {
+            m_iter = m_end;
+            return false;
+        }
+        m_iter = m_begin + *m_index;
+        return true;
+    }
+    while (m_iter != m_end && is_whitespace(*m_iter)) {
         m_iter++;
-        m_col++;
     }
+    return m_iter != m_end;
+}
 
-    auto lex() noexcept -> json::result<std::vector<json::token>> {
-        auto vec = std::vector<json::token>();
-        while (m_iter != m_end) {
-            if (*m_iter == '{') {
-                vec.emplace_back(json::symbol::lbrace, m_line, m_col);
-                advance();
-            } else if (*m_iter == '}') {
-                vec.emplace_back(json::symbol::rbrace, m_line, m_col);
-                advance();
-            } else if (*m_iter == '[') {
-                vec.emplace_back(json::symbol::lbracket, m_line, m_col);
-                advance();
-            } else if (*m_iter == ']') {
-                vec.emplace_back(json::symbol::rbracket, m_line, m_col);
-                advance();
-            } else if (*m_iter == ':') {
-                vec.emplace_back(json::symbol::colon, m_line, m_col);
-                advance();
-            } else if (*m_iter == ',') {
-                vec.emplace_back(json::symbol::comma, m_line, m_col);
+auto lexer::lex() noexcept -> json::result<std::vector<json::token>> {
+    auto vec = std::vector<json::token>();
+    while (skip_whitespace()) {
+        if (auto tok = lex_token()) {
+            vec.push_back(std::move(*tok));
+        } else {
+            return std::move(tok).error();
+        }
+    }
+    return vec;
+}
+
+auto lexer::lex_token() noexcept -> json::result<json::token> {
+    auto sym = [this](json::symbol s) {
+        auto [line, col] = position(m_iter);
+        advance();
+        return json::token(s, line, col);
+    };
+    switch (*m_iter) {
+        case '{':
+            return sym(json::symbol::lbrace);
+        case '}':
+            return sym(json::symbol::rbrace);
+        case '[':
+            return sym(json::symbol::lbracket);
+        case ']':
+            return sym(json::symbol::rbracket);
+        case ':':
+            return sym(json::symbol::colon);
+        case ',':
+            return sym(json::symbol::comma);
+        case '"':
+            return lex_string();
+        case 'n':
+        case 't':
+        case 'f':
+            return lex_literal();
+        default:
+            if (is_int(*m_iter) || *m_iter == '-') {
+                return lex_number();
+            }
+            return error_at(m_iter, "Lexer Error: Unexpected Token\""s + *m_iter + '"');
+    }
+}
+
+auto lexer::lex_number() noexcept -> json::result<json::token> {
+    const auto start = m_iter;
+    auto num = scan_number(m_iter, m_end);
+    m_iter = num.ptr;
+    if (num.ec == std::errc::invalid_argument) {
+        return error_at(start, "Lexer error: Invalid number literal \"" + std::string(start, m_iter) + "\"");
+    } else if (num.ec == std::errc::result_out_of_range) {
+        return error_at(start, "Lexer error: Number out of range \"" + std::string(start, m_iter) + "\"");
+    }
+    if (auto err = check_terminated(start)) {
+        return std::move(*err);
+    }
+    auto [line, col] = position(start);
+    return std::visit([line, col](auto x) { return json::token(x, line, col); }, num.value);
+}
+
+auto lexer::lex_string() noexcept -> json::result<json::token> {
+    const auto start = m_iter;
+    auto s = std::string();
+    if (auto err = lex_string(s)) {
+        return std::move(*err);
+    }
+    auto [line, col] = position(start);
+    return json::token(std::move(s), line, col);
+}
+
+template <class String>
+auto lexer::lex_string(String& s) noexcept -> std::optional<json::error> {
+    advance();
+    while (true) {
+        // Plain characters are copied a whole run at a time, up to the next quote, escape or control character
+        const auto special = find_string_special(m_iter, m_end);
+        s.append(m_iter, special);
+        m_iter = special;
+        if (m_iter == m_end) {
+            return error_at(m_iter, "Unexpected end of input while parsing string");
+        } else if (*m_iter == '"') {
+            break;
+        } else if (*m_iter == '\\') {
+            advance();
+            if (m_iter == m_end) {
+                return error_at(m_iter, "Unexpected end of input while parsing string");
+            }
+            if (*m_iter == 'u') {
                 advance();
-            } else if (is_int(*m_iter) || *m_iter == '-') {
-                if (auto tok = lex_number()) {
-                    vec.push_back(*tok);
-                } else {
-                    return tok.error();
-                }
-            } else if (*m_iter == '"') {
-                if (auto tok = lex_string()) {
-                    vec.push_back(*tok);
+                if (auto code_point = lex_unicode()) {
+                    s += std::string_view(utf8<char>(*code_point));
                 } else {
-                    return tok.error();
+                    return std::move(code_point).error();
                 }
-            } else if (*m_iter == '\n') {
-                m_col = 1;
-                m_line++;
-                m_iter++;
-            } else if (is_whitespace(*m_iter)) {
-                advance();
-            } else if (*m_iter == 'n' || *m_iter == 't' || *m_iter == 'f') {
-                if (auto tok = lex_literal()) {
-                    vec.push_back(*tok);
+            } else {
+                if (auto c = lex_escape()) {
+                    s.push_back(*c);
                 } else {
-                    return tok.error();
+                    return std::move(c).error();
                 }
-            } else {
-                return json::error(m_line, m_col, "Lexer Error: Unexpected Token\""s + *m_iter + '"');
             }
+        } else if (*m_iter == '\n') {
+            return error_at(m_iter, "Unexpected line break while parsing string");
+        } else {
+            return error_at(m_iter, "Unexpected control character while parsing string");
         }
-        return vec;
     }
+    advance();
+    return std::nullopt;
+}
 
-    auto lex_number() noexcept -> json::result<json::token> {
-        auto line = m_line;
-        auto col = m_col;
-        auto s = std::string();
-        auto is_float = false;
-        if (*m_iter == '-') {
-            s.push_back('-');
-            advance();
-        }
-        if (*m_iter == '0') {
-            s.push_back('0');
-            advance();
-        } else {
-            s += lex_digits();
+template auto lexer::lex_string(std::string&) noexcept -> std::optional<json::error>;
+template auto lexer::lex_string(std::pmr::string&) noexcept -> std::optional<json::error>;
+
+auto lexer::skip_string() noexcept -> std::optional<json::error> {
+    auto out = discard();
+    return lex_string(out);
+}
+
+auto lexer::skip_number() noexcept -> std::optional<json::error> {
+    const auto start = m_iter;
+    auto digits = [this] {
+        const auto first = m_iter;
+        while (m_iter != m_end && is_int(*m_iter)) {
+            m_iter++;
         }
-        if (*m_iter == '.') {
-            is_float = true;
-            s.push_back('.');
-            advance();
-            auto digits = lex_digits();
-            if (digits.empty()) {
-                return json::error(line, col, "Lexer error: Invalid number literal \"" + s + "\"");
-            }
-            s += digits;
+        return m_iter - first;
+    };
+    auto invalid = [this, start] {
+        return error_at(start, "Lexer error: Invalid number literal \"" + std::string(start, m_iter) + "\"");
+    };
+    if (*m_iter == '-') {
+        m_iter++;
+    }
+    // The number is below 10^magnitude, counting from its first nonzero digit
+    auto magnitude = std::int64_t(0);
+    auto nonzero = false;
+    if (m_iter != m_end && *m_iter == '0') {
+        m_iter++;
+    } else if (const auto n = digits()) {
+        magnitude = n;
+        nonzero = true;
+    } else {
+        return invalid();
+    }
+    if (m_iter != m_end && *m_iter == '.') {
+        m_iter++;
+        const auto fraction = m_iter;
+        if (!digits()) {
+            return invalid();
         }
-        if (is_exponent(*m_iter)) {
-            is_float = true;
-            s.push_back('e');
-            advance();
-            if (*m_iter == '-' || *m_iter == '+') {
-                s.push_back(*m_iter);
-                advance();
-            }
-            auto digits = lex_digits();
-            if (digits.empty()) {
-                return json::error(line, col, "Lexer error: Invalid number literal \"" + s + "\"");
-            }
-            s += digits;
+        if (!nonzero) {
+            const auto first = std::find_if(fraction, m_iter, [](char c) { return c != '0'; });
+            magnitude = -(first - fraction);
+            nonzero = first != m_iter;
         }
-        return is_float
-               ? json::token(std::stod(s), line, col)
-               : json::token(std::int64_t(std::stoll(s)), line, col);
     }
-
-    auto lex_string() noexcept -> json::result<json::token> {
-        auto line = m_line;
-        auto col = m_col;
-        advance();
-        std::string s;
-        while (m_iter != m_end && *m_iter != '"') {
-            if (*m_iter == '\\') {
-                advance();
-                if (*m_iter == 'u') {
-                    advance();
-                    if (auto bytes = lex_unicode()) {
-                        s += std::string_view(*bytes);
-                    } else {
-                        return bytes.error();
-                    }
-                } else {
-                    if (auto c = lex_escape()) {
-                        s.push_back(*c);
-                    } else {
-                        return c.error();
-                    }
-                }
-            } else if (*m_iter == '\n') {
-                return json::error(m_line, m_col, "Unexpected line break while parsing string");
-            } else {
-                s.push_back(*m_iter);
-                advance();
-            }
+    if (m_iter != m_end && is_exponent(*m_iter)) {
+        m_iter++;
+        const auto negative = m_iter != m_end && *m_iter == '-';
+        if (m_iter != m_end && (*m_iter == '-' || *m_iter == '+')) {
+            m_iter++;
         }
-        if (m_iter == m_end) {
-            return json::error(m_line, m_col, "Unexpected end of input while parsing string");
+        const auto exponent = m_iter;
+        auto e = std::int64_t(0);
+        for (; m_iter != m_end && is_int(*m_iter); m_iter++) {
+            e = std::min(e * 10 + (*m_iter - '0'), std::int64_t(1'000'000));
         }
-        advance();
-        return json::token(s, line, col);
+        if (m_iter == exponent) {
+            return invalid();
+        }
+        magnitude += negative ? -e : e;
+    }
+    // Anything from 10^309 up is too large for a double, and only the decade below that needs
+    // converting to be sure. Numbers too small round to zero, as lex_number() does.
+    if (nonzero && (magnitude > 309 || (magnitude == 309 && scan_number(start, m_iter).ec == std::errc::result_out_of_range))) {
+        return error_at(start, "Lexer error: Number out of range \"" + std::string(start, m_iter) + "\"");
     }
+    return check_terminated(start);
+}
 
-    auto lex_literal() noexcept -> json::result<json::token> {
-        auto line = m_line;
-        auto col = m_col;
-        auto err = [line, col](std::string_view s) {
-            auto e = "Lexer Error: Unknown literal \""s;
-            e += s;
-            return json::error(line, col, e + '"');
-        };
-        if (*m_iter == 'n' || *m_iter == 't') {
-            if (m_end - m_iter < 4) {
-                return err(std::string_view(m_iter, m_end - m_iter));
-            }
-            auto s = std::string_view(m_iter, 4);
-            if (s == "null") {
-                m_iter += 4;
-                m_col += 4;
-                return json::token({}, line, col);
-            } else if (s == "true") {
-                m_iter += 4;
-                m_col += 4;
-                return json::token(true, line, col);
-            } else {
-                return err(s);
-            }
-        } else {
-            if (m_end - m_iter < 5) {
-                return err(std::string_view(m_iter, m_end - m_iter));
-            }
-            auto s = std::string_view(m_iter, 5);
-            if (s == "false") {
-                m_iter += 5;
-                m_col += 5;
-                return json::token(false, line, col);
-            } else {
-                return err(s);
-            }
-        }
+auto lexer::lex_string_view(std::string& scratch) noexcept -> json::result<std::string_view> {
+    const auto first = m_iter + 1;
+    const auto special = find_string_special(first, m_end);
+    if (special != m_end && *special == '"') {
+        m_iter = special + 1;
+        return std::string_view(first, special);
     }
+    scratch.clear();
+    if (auto err = lex_string(scratch)) {
+        return std::move(*err);
+    }
+    return std::string_view(scratch);
+}
 
-    auto lex_digits() noexcept -> std::string {
-        std::string s;
-        while (m_iter != m_end && is_int(*m_iter)) {
-            s.push_back(*m_iter);
-            advance();
-        }
-        return s;
+auto lexer::unexpected_token(std::string_view prefix, std::string_view suffix) noexcept -> json::error {
+    auto tok = lex_token();
+    if (!tok) {
+        return tok.error();
     }
+    auto msg = std::string(prefix);
+    msg += to_string(*tok);
+    msg += suffix;
+    return json::error(tok->line, tok->col, msg);
+}
 
-    auto lex_escape() noexcept -> json::result<char> {
-        auto c = *m_iter;
-        advance();
-        switch (c) {
-            case '"':
-                return '"';
-            case '\\':
-                return '\\';
-            case 'b':
-                return '\b';
-            case 'f':
-                return '\f';
-            case 'n':
-                return '\n';
-            case 'r':
-                return '\r';
-            case 't':
-                return '\t';
+auto lexer::lex_literal() noexcept -> json::result<json::token> {
+    const auto start = m_iter;
+    auto err = [this, start](std::string_view s) {
+        auto e = "Lexer Error: Unknown literal \""s;
+        e += s;
+        return error_at(start, e + '"');
+    };
+    auto literal = [this, start](auto val, std::size_t n) -> json::result<json::token> {
+        m_iter += n;
+        if (auto e = check_terminated(start)) {
+            return std::move(*e);
+        }
+        auto [line, col] = position(start);
+        return json::token(val, line, col);
+    };
+    if (*m_iter == 'n' || *m_iter == 't') {
+        if (m_end - m_iter < 4) {
+            return err(std::string_view(m_iter, m_end - m_iter));
+        }
+        auto s = std::string_view(m_iter, 4);
+        if (s == "null") {
+            return literal(json::null(), 4);
+        } else if (s == "true") {
+            return literal(true, 4);
+        } else {
+            return err(s);
+        }
+    } else {
+        if (m_end - m_iter < 5) {
+            return err(std::string_view(m_iter, m_end - m_iter));
+        }
+        auto s = std::string_view(m_iter, 5);
+        if (s == "false") {
+            return literal(false, 5);
+        } else {
+            return err(s);
         }
-        return json::error(m_line, m_col, "Lexer Error: Invalid escape character "s + '\\' + c);
     }
+}
 
-    auto lex_unicode() noexcept -> json::result<utf8<char>> {
-        auto s = std::string();
-        for (auto i = 0; i < 4; i++) {
-            auto c = *m_iter;
-            if (!is_hex(c)) {
-                return json::error(m_line, m_col, "Lexer Error: Invalid hex character "s + c);
-            }
-            s.push_back(c);
-            advance();
+auto lexer::lex_escape() noexcept -> json::result<char> {
+    auto c = *m_iter;
+    advance();
+    switch (c) {
+        case '"':
+            return '"';
+        case '\\':
+            return '\\';
+        case '/':
+            return '/';
+        case 'b':
+            return '\b';
+        case 'f':
+            return '\f';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+    }
+    return error_at(m_iter, "Lexer Error: Invalid escape character "s + '\\' + c);
+}
+
+auto lexer::lex_hex4() noexcept -> std::optional<std::uint16_t> {
+    auto x = 0u;
+    for (auto i = 0; i < 4; i++, m_iter++) {
+        if (m_iter == m_end) {
+            return std::nullopt;
+        }
+        const auto c = *m_iter;
+        const auto lower = char(c | 0x20);
+        if (is_int(c)) {
+            x = (x << 4) | unsigned(c - '0');
+        } else if (lower >= 'a' && lower <= 'f') {
+            x = (x << 4) | unsigned(lower - 'a' + 10);
+        } else {
+            return std::nullopt;
         }
-        return utf8<char>(cast<std::uint16_t>(std::stoi(s, 0, 16)));
     }
+    return cast<std::uint16_t>(x);
+}
 
-private:
-    std::string_view::const_iterator m_iter;
-    std::string_view::const_iterator m_end;
-    std::int32_t m_line = 1;
-    std::int32_t m_col = 1;
-};
+// Decodes the 4 hex digits after "\u", combining a UTF-16 surrogate pair into one code point
+auto lexer::lex_unicode() noexcept -> json::result<std::uint32_t> {
+    const auto start = m_iter - 2;
+    auto invalid_hex = [this] {
+        return error_at(m_iter, "Lexer Error: Invalid hex character "s + (m_iter == m_end ? ""s : std::string(1, *m_iter)));
+    };
+    auto unpaired = [this, start] {
+        return error_at(start, "Lexer Error: Unpaired surrogate in unicode escape");
+    };
+    const auto high = lex_hex4();
+    if (!high) {
+        return invalid_hex();
+    }
+    if (*high >= 0xDC00 && *high <= 0xDFFF) {
+        return unpaired();
+    }
+    if (*high < 0xD800 || *high > 0xDBFF) {
+        return std::uint32_t(*high);
+    }
+    if (m_end - m_iter < 2 || m_iter[0] != '\\' || m_iter[1] != 'u') {
+        return unpaired();
+    }
+    m_iter += 2;
+    const auto low = lex_hex4();
+    if (!low) {
+        return invalid_hex();
+    }
+    if (*low < 0xDC00 || *low > 0xDFFF) {
+        return unpaired();
+    }
+    return 0x10000 + ((std::uint32_t(*high) - 0xD800) << 10) + (std::uint32_t(*low) - 0xDC00);
+}
 
 }
 
 auto json::lex(std::string_view s) noexcept -> result <std::vector<token>> {
-    return Lexer(s.cbegin(), s.cend()).lex();
+    return json::detail::lexer(s).lex();
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "../include/meejson/parallel.hpp"
+#include "../include/meejson/compact.hpp"
+#include "../include/meejson/lazy.hpp"
+#include "../include/meejson/ordered_object.hpp"
+#include "../include/meejson/sax.hpp"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <optional>
+#include <thread>
+
+namespace mee {
+
+namespace {
+
+using json::detail::dom_builder;
+using json::detail::lexer;
+using json::detail::sax_parser;
+
+// An error and where the value it was found in starts, so the first in the text can be kept
+struct located_error {
+    std::size_t offset;
+    json::error err;
+};
+
+void keep_first(std::optional<located_error>& first, std::size_t offset, json::error&& err) {
+    if (!first || offset < first->offset) {
+        first = located_error{offset, std::move(err)};
+    }
+}
+
+template <class Value>
+struct parallel_parser {
+    using array_type = typename Value::array_type;
+    using object_type = typename Value::object_type;
+    using string_type = typename Value::string_type;
+
+    parallel_parser(std::string_view s, const std::vector<std::uint32_t>& index, const std::vector<std::uint32_t>& ends,
+                    const json::parallel_options& options)
+    : m_text(s), m_index(index), m_ends(ends), m_options(options), m_parser(lexer(s, index), m_builder, options.parse) {}
+
+    auto parse(std::size_t threads) -> json::result<Value> {
+        auto root = build(0, 0);
+        run(threads);
+        if (m_error) {
+            return std::move(m_error->err);
+        }
+        return root;
+    }
+
+private:
+    // An element of a split array, parsed straight into its place
+    struct task {
+        Value* slot;
+        std::uint32_t pos;
+    };
+
+    [[nodiscard]] auto offset(std::uint32_t pos) const noexcept -> std::size_t {
+        return m_index[pos];
+    }
+
+    [[nodiscard]] auto at(std::uint32_t pos) const noexcept -> char {
+        return m_text[m_index[pos]];
+    }
+
+    // Position of the element or member after the one whose value is at `pos`, or of the closing
+    // bracket
+    [[nodiscard]] auto next(std::uint32_t pos) const noexcept -> std::uint32_t {
+        const auto c = at(pos);
+        const auto after = (c == '[' || c == '{' ? m_ends[pos] : pos) + 1;
+        return at(after) == ',' ? after + 1 : after;
+    }
+
+    [[nodiscard]] auto splits(std::uint32_t pos, std::size_t depth) const noexcept -> bool {
+        const auto c = at(pos);
+        return (c == '[' || c == '{') && depth <= m_options.split_depth && offset(m_ends[pos]) - offset(pos) >= m_options.min_split_bytes;
+    }
+
+    // Builds the arrays and objects down to the split arrays, leaving their elements as tasks
+    auto build(std::uint32_t pos, std::size_t depth) -> Value {
+        if (!splits(pos, depth)) {
+            return parse_at(m_parser, m_builder, offset(pos), m_error);
+        }
+        if (at(pos) == '[') {
+            auto n = std::size_t(0);
+            for (auto e = pos + 1; e != m_ends[pos]; e = next(e)) {
+                n++;
+            }
+            auto arr = array_type();
+            arr.resize(n);
+            auto i = std::size_t(0);
+            for (auto e = pos + 1; e != m_ends[pos]; e = next(e), i++) {
+                if (splits(e, depth + 1)) {
+                    arr[i] = build(e, depth + 1);
+                } else {
+                    m_tasks.push_back(task{&arr[i], e});
+                }
+            }
+            return Value(std::move(arr));
+        }
+        auto obj = object_type();
+        for (auto k = pos + 1; k != m_ends[pos]; k = next(k + 2)) {
+            auto& lex = m_parser.get_lexer();
+            lex.seek(offset(k));
+            auto key = lex.lex_string_view(m_scratch);
+            if (!key) {
+                keep_first(m_error, offset(k), std::move(key).error());
+                continue;
+            }
+            // Nested keys reuse the scratch buffer, so the name is copied out before building
+            auto name = string_type(*key);
+            if (obj.contains(name)) {
+                // As in parse() the first member wins. A later one is parsed serially, so it reports
+                // the same errors but leaves no tasks pointing into a value that is thrown away.
+                static_cast<void>(parse_at(m_parser, m_builder, offset(k + 2), m_error));
+                continue;
+            }
+            auto val = build(k + 2, depth + 1);
+            obj.insert(std::pair(std::move(name), std::move(val)));
+        }
+        return Value(std::move(obj));
+    }
+
+    static auto parse_at(sax_parser<dom_builder<Value>>& parser, dom_builder<Value>& builder, std::size_t offset,
+                         std::optional<located_error>& error) -> Value {
+        parser.get_lexer().seek(offset);
+        builder = dom_builder<Value>();
+        if (auto err = parser.parse_next()) {
+            keep_first(error, offset, std::move(*err));
+            return Value();
+        }
+        return builder.take();
+    }
+
+    void run(std::size_t threads) {
+        if (m_tasks.empty()) {
+            return;
+        }
+        // Hand out runs of elements spanning at least `target` bytes, several per thread so
+        // uneven runs even out
+        const auto span = offset(m_tasks.back().pos) - offset(m_tasks.front().pos);
+        const auto target = std::max(span / (threads * 8), std::size_t(1) << 12);
+        m_chunks.push_back(0);
+        for (auto i = std::size_t(1); i < m_tasks.size(); i++) {
+            if (offset(m_tasks[i].pos) - offset(m_tasks[m_chunks.back()].pos) >= target) {
+                m_chunks.push_back(i);
+            }
+        }
+        m_chunks.push_back(m_tasks.size());
+        if (m_error) {
+            m_first_error = m_error->offset;
+        }
+
+        threads = std::min(threads, m_chunks.size() - 1);
+        auto errors = std::vector<std::optional<located_error>>(threads);
+        auto workers = std::vector<std::thread>();
+        for (auto t = std::size_t(1); t < threads; t++) {
+            workers.emplace_back([this, &error = errors[t]] { work(error); });
+        }
+        work(errors[0]);
+        for (auto& w : workers) {
+            w.join();
+        }
+        for (auto& err : errors) {
+            if (err) {
+                keep_first(m_error, err->offset, std::move(err->err));
+            }
+        }
+    }
+
+    void work(std::optional<located_error>& error) {
+        auto builder = dom_builder<Value>();
+        auto parser = sax_parser(lexer(m_text, m_index), builder, m_options.parse);
+        while (true) {
+            const auto c = m_next_chunk++;
+            // Chunks are taken in order, so once an error has been found every later chunk would
+            // be wasted work
+            if (c + 1 >= m_chunks.size() || offset(m_tasks[m_chunks[c]].pos) > m_first_error) {
+                return;
+            }
+            for (auto i = m_chunks[c]; i < m_chunks[c + 1]; i++) {
+                *m_tasks[i].slot = parse_at(parser, builder, offset(m_tasks[i].pos), error);
+                if (error) {
+                    for (auto first = m_first_error.load(); error->offset < first && !m_first_error.compare_exchange_weak(first, error->offset);) {
+                    }
+                    return;
+                }
+            }
+        }
+    }
+
+    std::string_view m_text;
+    const std::vector<std::uint32_t>& m_index;
+    const std::vector<std::uint32_t>& m_ends;
+    const json::parallel_options& m_options;
+
+    // Parses everything outside the split arrays
+    dom_builder<Value> m_builder;
+    sax_parser<dom_builder<Value>> m_parser;
+    std::string m_scratch;
+
+    std::vector<task> m_tasks;
+    // Each chunk is the tasks [m_chunks[i], m_chunks[i + 1])
+    std::vector<std::size_t> m_chunks;
+    std::atomic<std::size_t> m_next_chunk = 0;
+    std::atomic<std::size_t> m_first_error = std::numeric_limits<std::size_t>::max();
+    std::optional<located_error> m_error;
+};
+
+}
+
+template <class Value>
+auto json::parse_parallel(std::string_view s, const parallel_options& options) noexcept -> result<Value> {
+    const auto threads = options.threads ? options.threads : std::size_t(std::max(std::thread::hardware_concurrency(), 1u));
+    // Projections are applied by parse() alone
+    if (threads == 1 || options.parse.fields || s.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return parse<Value>(s, options.parse);
+    }
+    const auto index = detail::index_structurals(s);
+    auto ends = std::vector<std::uint32_t>(index.size());
+    // A malformed scalar before a structural error would be reported first, so any error is left
+    // for parse() to find
+    if (detail::check_structure(s, index, ends, options.parse)) {
+        return parse<Value>(s, options.parse);
+    }
+    return parallel_parser<Value>(s, index, ends, options).parse(threads);
+}
+
+template auto json::parse_parallel<json::value>(std::string_view, const parallel_options&) noexcept -> result<json::value>;
+template auto json::parse_parallel<json::compact::value>(std::string_view, const parallel_options&) noexcept -> result<json::compact::value>;
+template auto json::parse_parallel<json::ordered_value>(std::string_view, const parallel_options&) noexcept -> result<json::ordered_value>;
+
+auto json::parse_parallel(std::string_view s, const parallel_options& options) noexcept -> result<value> {
+    return parse_parallel<value>(s, options);
+}
+
+}
@@ -1,4 +1,9 @@
 #include "../include/meejson/parser.hpp"
+#include "../include/meejson/compact.hpp"
+#include "../include/meejson/document.hpp"
+#include "../include/meejson/ordered_object.hpp"
+#include "../include/meejson/projection.hpp"
+#include "../include/meejson/sax.hpp"
 #include "../include/meejson/type_list.hpp"
 
 using namespace std::literals;
@@ -8,33 +13,8 @@ namespace mee {
 namespace {
 
 using json::detail::overload;
-
-auto to_string(const json::token& t) noexcept -> std::string {
-    using json::symbol;
-    return std::visit(overload{
-    [](symbol t) {
-        switch (t) {
-            case symbol::lbracket:
-                return "["s;
-            case symbol::rbracket:
-                return "]"s;
-            case symbol::lbrace:
-                return "{"s;
-            case symbol::rbrace:
-                return "}"s;
-            case symbol::colon:
-                return ":"s;
-            case symbol::comma:
-                return ","s;
-        };
-        std::terminate();
-    },
-    [](const std::string& s) { return '"' + s + '"'; },
-    [](json::null) { return "null"s; },
-    [](bool b) { return b ? "true"s : "false"s; },
-    [](const auto& x) { return std::to_string(x); }
-    }, t.tok);
-}
+using json::detail::to_string;
+using json::detail::depth_exceeded;
 
 template<class... Ts, class T>
 requires json::in_type_list<T, json::type_list<Ts...>>
@@ -45,9 +25,27 @@ constexpr auto operator==(const std::variant<Ts...>& lhs, const T& rhs) noexcept
     }, lhs);
 }
 
-struct Parser {
-    Parser(std::vector<json::token>::const_iterator iter, std::vector<json::token>::const_iterator end) noexcept
-    : m_iter(iter), m_end(end) {}
+// Counts the aggregates currently open in a recursive parser
+struct depth_guard {
+    explicit depth_guard(std::size_t& depth) noexcept : m_depth(depth) {
+        m_depth++;
+    }
+
+    ~depth_guard() {
+        m_depth--;
+    }
+
+    depth_guard(const depth_guard&) = delete;
+    auto operator=(const depth_guard&) -> depth_guard& = delete;
+
+private:
+    std::size_t& m_depth;
+};
+
+struct TokenParser {
+    TokenParser(std::vector<json::token>::const_iterator iter, std::vector<json::token>::const_iterator end,
+                const json::parse_options& options) noexcept
+    : m_iter(iter), m_end(end), m_options(options) {}
 
     auto parse() noexcept -> json::result<json::value> {
         if (m_iter == m_end) {
@@ -61,7 +59,7 @@ struct Parser {
             const auto&[t, line, col] = *m_iter;
             return json::error(line, col, "Parser Error: Unexpected token " + to_string(*m_iter));
         }
-        return *val;
+        return std::move(*val);
     }
 
     auto parse_value() noexcept -> json::result<json::value> {
@@ -90,7 +88,7 @@ struct Parser {
 
     auto parse_array() noexcept -> json::result<json::value> {
         return parse_aggregate<json::array>(
-        [](Parser& self) { return self.parse_value(); },
+        [](TokenParser& self) { return self.parse_value(); },
         [](json::array& arr, auto&& val) { return arr.push_back(std::forward<decltype(val)>(val)); },
         json::symbol::rbracket
         );
@@ -98,7 +96,7 @@ struct Parser {
 
     auto parse_object() noexcept -> json::result<json::value> {
         return parse_aggregate<json::object>(
-        [](Parser& self) { return self.parse_key_value_pair(); },
+        [](TokenParser& self) { return self.parse_key_value_pair(); },
         [](json::object& arr, auto&& val) { return arr.insert(std::forward<decltype(val)>(val)); },
         json::symbol::rbrace
         );
@@ -106,6 +104,10 @@ struct Parser {
 
     template<class T, class Parse, class Add>
     auto parse_aggregate(Parse&& parse, Add&& add, json::symbol end) -> json::result<json::value> {
+        const auto guard = depth_guard(m_depth);
+        if (m_depth > m_options.max_depth) {
+            return depth_exceeded(m_iter->line, m_iter->col, m_options.max_depth);
+        }
         auto arr = T();
         m_iter++;
         if (m_iter == m_end) {
@@ -114,10 +116,10 @@ struct Parser {
         }
         if (m_iter->tok == end) {
             m_iter++;
-            return json::value(arr);
+            return json::value(std::move(arr));
         } else {
             if (auto val = parse(*this)) {
-                add(arr, *val);
+                add(arr, std::move(*val));
             } else {
                 return val.error();
             }
@@ -126,11 +128,11 @@ struct Parser {
         while (m_iter != m_end) {
             if (m_iter->tok == end) {
                 m_iter++;
-                return json::value(arr);
+                return json::value(std::move(arr));
             } else if (m_iter->tok == json::symbol::comma) {
                 m_iter++;
                 if (auto val = parse(*this)) {
-                    add(arr, *val);
+                    add(arr, std::move(*val));
                 } else {
                     return val.error();
                 }
@@ -162,7 +164,7 @@ struct Parser {
             return json::error(key.line, key.col, "Parser Error: Unexpected end of tokens, expecting value");
         }
         if (auto val = parse_value()) {
-            return std::pair(std::get<std::string>(key.tok), *val);
+            return std::pair(std::get<std::string>(key.tok), std::move(*val));
         } else {
             return val.error();
         }
@@ -171,21 +173,220 @@ struct Parser {
 private:
     std::vector<json::token>::const_iterator m_iter;
     std::vector<json::token>::const_iterator m_end;
+    json::parse_options m_options;
+    std::size_t m_depth = 0;
 };
 
+// Builds values straight from the character stream, pulling one token at a time from the lexer and
+// recursing into each array and object
+struct RecursiveParser {
+    RecursiveParser(std::string_view s, const json::parse_options& options) noexcept
+    : m_lexer(s), m_options(options) {}
+
+    RecursiveParser(std::string_view s, const std::vector<std::uint32_t>& index, const json::parse_options& options) noexcept
+    : m_lexer(s, index), m_options(options) {}
+
+    auto parse() noexcept -> json::result<json::value> {
+        if (!m_lexer.skip_whitespace()) {
+            return json::error(1, 1, "Parser Error: Unable to parse empty string");
+        }
+        auto val = parse_value();
+        if (!val) {
+            return val.error();
+        }
+        if (m_lexer.skip_whitespace()) {
+            return m_lexer.unexpected_token("Parser Error: Unexpected token ", "");
+        }
+        return std::move(*val);
+    }
+
+    auto parse_value() noexcept -> json::result<json::value> {
+        if (!m_lexer.skip_whitespace()) {
+            return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input");
+        }
+        switch (m_lexer.peek()) {
+            case '{':
+                return parse_object();
+            case '[':
+                return parse_array();
+            default:
+                break;
+        }
+        auto tok = m_lexer.lex_token();
+        if (!tok) {
+            return tok.error();
+        }
+        return std::visit(overload{
+        [&tok](json::symbol) -> json::result<json::value> {
+            return json::error(tok->line, tok->col, "Parser Error: Unexpected token " + to_string(*tok));
+        },
+        [](auto& val) -> json::result<json::value> {
+            return json::value(std::move(val));
+        },
+        }, tok->tok);
+    }
+
+    auto parse_array() noexcept -> json::result<json::value> {
+        return parse_aggregate<json::array>(
+        [](RecursiveParser& self) { return self.parse_value(); },
+        [](json::array& arr, auto&& val) { return arr.push_back(std::forward<decltype(val)>(val)); },
+        ']'
+        );
+    }
+
+    auto parse_object() noexcept -> json::result<json::value> {
+        return parse_aggregate<json::object>(
+        [](RecursiveParser& self) { return self.parse_key_value_pair(); },
+        [](json::object& arr, auto&& val) { return arr.insert(std::forward<decltype(val)>(val)); },
+        '}'
+        );
+    }
+
+    template<class T, class Parse, class Add>
+    auto parse_aggregate(Parse&& parse, Add&& add, char end) -> json::result<json::value> {
+        const auto guard = depth_guard(m_depth);
+        if (m_depth > m_options.max_depth) {
+            return depth_exceeded(m_lexer.line(), m_lexer.col(), m_options.max_depth);
+        }
+        auto arr = T();
+        m_lexer.advance();
+        if (!m_lexer.skip_whitespace()) {
+            return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input, expected value");
+        }
+        if (m_lexer.peek() == end) {
+            m_lexer.advance();
+            return json::value(std::move(arr));
+        } else {
+            if (auto val = parse(*this)) {
+                add(arr, std::move(*val));
+            } else {
+                return val.error();
+            }
+        }
+
+        while (m_lexer.skip_whitespace()) {
+            if (m_lexer.peek() == end) {
+                m_lexer.advance();
+                return json::value(std::move(arr));
+            } else if (m_lexer.peek() == ',') {
+                m_lexer.advance();
+                if (auto val = parse(*this)) {
+                    add(arr, std::move(*val));
+                } else {
+                    return val.error();
+                }
+            } else {
+                return m_lexer.unexpected_token("Unexpected token '", "' Expected ','");
+            }
+        }
+        return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input");
+    }
+
+    auto parse_key_value_pair() noexcept -> json::result<std::pair<std::string, json::value>> {
+        if (!m_lexer.skip_whitespace()) {
+            return json::error(m_lexer.line(), m_lexer.col(), "Parser Error: Unexpected end of input, expecting key");
+        }
+        if (m_lexer.peek() != '"') {
+            return m_lexer.unexpected_token("Parser Error: Invalid object key '", "', expecting string.");
+        }
+        auto key = m_lexer.lex_string();
+        if (!key) {
+            return key.error();
+        }
+        if (!m_lexer.skip_whitespace()) {
+            return json::error(key->line, key->col, "Parser Error: Unexpected end of input, expecting ':'");
+        }
+        if (m_lexer.peek() != ':') {
+            return m_lexer.unexpected_token("Parser Error: Unexpected token '", "' expected ':'");
+        }
+        m_lexer.advance();
+        if (auto val = parse_value()) {
+            return std::pair(std::get<std::string>(std::move(key->tok)), std::move(*val));
+        } else {
+            return val.error();
+        }
+    }
+
+private:
+    json::detail::lexer m_lexer;
+    json::parse_options m_options;
+    std::size_t m_depth = 0;
+};
+
+template <class Value, class... Args>
+auto parse_dom(std::string_view s, const json::parse_options& options, Args&&... args) noexcept -> json::result<Value> {
+    auto builder = json::detail::dom_builder<Value>(std::forward<Args>(args)...);
+    if (options.fields) {
+        auto projector = json::detail::projecting_handler(builder, *options.fields);
+        if (auto err = json::parse_sax(s, projector, options)) {
+            return std::move(*err);
+        }
+    } else if (auto err = json::parse_sax(s, builder, options)) {
+        return std::move(*err);
+    }
+    return builder.take();
+}
+
+template <class P, class... Args>
+auto parse_with(std::string_view s, const json::parse_options& options, Args&&... args) noexcept -> decltype(P(s, options, args...).parse()) {
+    if (s.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return P(s, options, std::forward<Args>(args)...).parse();
+    }
+    const auto index = json::detail::index_structurals(s);
+    return P(s, index, options, std::forward<Args>(args)...).parse();
+}
+
 }
 
-auto json::parse(std::string_view s) noexcept -> json::result<json::value> {
-    auto toks = json::lex(s);
-    if (toks) {
-        return json::parse(*toks);
-    } else {
-        return toks.error();
+auto json::parse(std::string_view s, const parse_options& options) noexcept -> json::result<json::value> {
+    return parse_dom<json::value>(s, options);
+}
+
+template <class Value>
+auto json::parse(std::string_view s, const parse_options& options) noexcept -> json::result<Value> {
+    return parse_dom<Value>(s, options);
+}
+
+template auto json::parse<json::value>(std::string_view, const parse_options&) noexcept -> json::result<json::value>;
+template auto json::parse<json::compact::value>(std::string_view, const parse_options&) noexcept -> json::result<json::compact::value>;
+template auto json::parse<json::ordered_value>(std::string_view, const parse_options&) noexcept -> json::result<json::ordered_value>;
+
+auto json::parse(const std::vector<json::token>& toks, const parse_options& options) noexcept -> json::result<json::value> {
+    return TokenParser(toks.begin(), toks.end(), options).parse();
+}
+
+auto json::detail::parse_recursive(std::string_view s, const parse_options& options) noexcept -> json::result<json::value> {
+    return parse_with<RecursiveParser>(s, options);
+}
+
+template <class Value>
+auto json::detail::parse_arena(std::string_view s, std::shared_ptr<const void> source, const parse_options& options) noexcept
+    -> json::result<basic_document<Value>> {
+    // The first block matches the input and later ones grow geometrically, so small documents take a
+    // few blocks and a large mapped file never reserves a multiple of itself up front
+    auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>(std::max(s.size(), std::size_t(1024)),
+                                                                       std::pmr::new_delete_resource());
+    auto alloc = std::pmr::polymorphic_allocator<>(arena.get());
+    auto val = parse_dom<Value>(s, options, alloc, s);
+    if (!val) {
+        return std::move(val).error();
     }
+    auto root = alloc.allocate_object<Value>();
+    std::construct_at(root, std::move(*val));
+    return basic_document<Value>(std::move(source), std::move(arena), root);
+}
+
+template auto json::detail::parse_arena<json::pmr::value>(std::string_view, std::shared_ptr<const void>, const parse_options&) noexcept
+    -> json::result<document>;
+template auto json::detail::parse_arena<json::view::value>(std::string_view, std::shared_ptr<const void>, const parse_options&) noexcept
+    -> json::result<view_document>;
+
+auto json::parse_document(std::string_view s, const parse_options& options) noexcept -> json::result<document> {
+    return detail::parse_arena<pmr::value>(s, nullptr, options);
 }
 
-auto json::parse(const std::vector<json::token>& toks) noexcept -> json::result<json::value> {
-    return Parser(toks.begin(), toks.end()).parse();
+auto json::parse_view_document(std::string_view s, const parse_options& options) noexcept -> json::result<view_document> {
+    return detail::parse_arena<view::value>(s, nullptr, options);
 }
 
 auto json::operator""_json(const char* s, std::size_t n) -> value {
@@ -193,7 +394,7 @@ auto json::operator""_json(const char* s, std::size_t n) -> value {
     if (!res) {
         throw json::error_exception(res.error());
     }
-    return *res;
+    return std::move(*res);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "../include/meejson/projection.hpp"
+#include "../include/meejson/except.hpp"
+#include <algorithm>
+#include <charconv>
+
+namespace mee {
+
+auto json::detail::split_pointer(std::string_view s) -> result<std::vector<std::string>> {
+    auto tokens = std::vector<std::string>();
+    if (s.empty()) {
+        return tokens;
+    }
+    if (s[0] != '/') {
+        return error(1, 1, "Pointer Error: Expected '/' at the start of \"" + std::string(s) + '"');
+    }
+    for (auto i = std::size_t(1);; i++) {
+        auto& token = tokens.emplace_back();
+        for (; i < s.size() && s[i] != '/'; i++) {
+            if (s[i] != '~') {
+                token += s[i];
+            } else if (i + 1 < s.size() && (s[i + 1] == '0' || s[i + 1] == '1')) {
+                token += s[++i] == '0' ? '~' : '/';
+            } else {
+                return error(1, std::int32_t(i) + 1, "Pointer Error: Invalid escape in \"" + std::string(s) + '"');
+            }
+        }
+        if (i == s.size()) {
+            return tokens;
+        }
+    }
+}
+
+json::projection::projection(std::initializer_list<std::string_view> paths) {
+    for (const auto path : paths) {
+        add(path);
+    }
+}
+
+json::projection::projection(const std::vector<std::string>& paths) {
+    for (const auto& path : paths) {
+        add(path);
+    }
+}
+
+void json::projection::add(std::string_view path) {
+    auto tokens = detail::split_pointer(path);
+    if (!tokens) {
+        throw error_exception(tokens.error());
+    }
+    auto n = std::size_t(0);
+    for (auto& token : *tokens) {
+        auto& children = m_nodes[n].children;
+        const auto it = std::find_if(children.begin(), children.end(), [&token](const auto& c) { return c.first == token; });
+        if (it != children.end()) {
+            n = it->second;
+            continue;
+        }
+        children.emplace_back(std::move(token), m_nodes.size());
+        n = m_nodes.size();
+        m_nodes.emplace_back();
+    }
+    m_nodes[n].whole = true;
+}
+
+auto json::projection::child(std::size_t node, std::string_view key) const noexcept -> std::size_t {
+    if (node == npos || m_nodes[node].whole) {
+        return node;
+    }
+    for (const auto& [k, n] : m_nodes[node].children) {
+        if (k == key) {
+            return n;
+        }
+    }
+    return npos;
+}
+
+auto json::projection::child(std::size_t node, std::size_t index) const noexcept -> std::size_t {
+    if (node == npos || m_nodes[node].whole) {
+        return node;
+    }
+    char buf[20];
+    const auto end = std::to_chars(buf, buf + sizeof(buf), index).ptr;
+    return child(node, std::string_view(buf, std::size_t(end - buf)));
+}
+
+}
@@ -0,0 +1,410 @@
+#include "../include/meejson/query.hpp"
+#include "../include/meejson/lexer.hpp"
+#include "../include/meejson/projection.hpp"
+#include <algorithm>
+
+using namespace std::literals;
+
+namespace mee {
+
+namespace {
+
+using json::detail::child_key;
+using json::detail::comparison;
+using json::detail::literal;
+using json::detail::segment;
+using json::detail::selector;
+
+auto name_key(std::string name) -> child_key {
+    const auto hash = json::hashed_key(name).hash;
+    return child_key{std::move(name), hash, std::nullopt};
+}
+
+auto index_key(std::int64_t i) -> child_key {
+    return child_key{std::nullopt, 0, i};
+}
+
+// A pointer token names a member, and an element too when it is written like an array index
+auto pointer_key(std::string token) -> child_key {
+    auto key = name_key(std::move(token));
+    const auto& s = *key.name;
+    if (!s.empty() && s.size() <= 18 && (s == "0" || s[0] != '0') && std::all_of(s.begin(), s.end(), json::detail::lexer::is_int)) {
+        key.index = std::stoll(s);
+    }
+    return key;
+}
+
+auto compile_pointer(std::string_view s) -> json::result<std::vector<segment>> {
+    auto tokens = json::detail::split_pointer(s);
+    if (!tokens) {
+        return std::move(tokens).error();
+    }
+    auto segments = std::vector<segment>();
+    for (auto& token : *tokens) {
+        segments.push_back(segment{false, {selector{selector::kind::key, pointer_key(std::move(token)), {}}}});
+    }
+    return segments;
+}
+
+struct path_parser {
+    explicit path_parser(std::string_view s) noexcept : m_s(s) {}
+
+    auto parse() -> json::result<std::vector<segment>> {
+        auto segments = std::vector<segment>();
+        m_pos = 1;
+        while (m_pos < m_s.size()) {
+            auto seg = segment();
+            if (m_s.substr(m_pos, 2) == "..") {
+                seg.descendant = true;
+                m_pos += 2;
+                if (peek() != '[') {
+                    if (auto err = parse_dotted(seg)) {
+                        return std::move(*err);
+                    }
+                } else if (auto err = parse_bracket(seg)) {
+                    return std::move(*err);
+                }
+            } else if (peek() == '.') {
+                m_pos++;
+                if (auto err = parse_dotted(seg)) {
+                    return std::move(*err);
+                }
+            } else if (peek() == '[') {
+                if (auto err = parse_bracket(seg)) {
+                    return std::move(*err);
+                }
+            } else {
+                return fail("Expected '.' or '['");
+            }
+            segments.push_back(std::move(seg));
+        }
+        return segments;
+    }
+
+private:
+    [[nodiscard]] auto peek() const noexcept -> char {
+        return m_pos < m_s.size() ? m_s[m_pos] : '\0';
+    }
+
+    void skip_space() noexcept {
+        while (m_pos < m_s.size() && json::detail::lexer::is_whitespace(m_s[m_pos])) {
+            m_pos++;
+        }
+    }
+
+    auto fail(std::string_view msg) const -> json::error {
+        return json::error(1, std::int32_t(m_pos) + 1, "Query Error: " + std::string(msg));
+    }
+
+    static auto is_name_char(char c) noexcept -> bool {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || json::detail::lexer::is_int(c) || (c & 0x80);
+    }
+
+    auto parse_name() -> std::optional<std::string> {
+        const auto start = m_pos;
+        if (m_pos == m_s.size() || !is_name_char(m_s[m_pos]) || json::detail::lexer::is_int(m_s[m_pos])) {
+            return std::nullopt;
+        }
+        while (m_pos < m_s.size() && is_name_char(m_s[m_pos])) {
+            m_pos++;
+        }
+        return std::string(m_s.substr(start, m_pos - start));
+    }
+
+    // `.name` or `.*`, after the dot
+    auto parse_dotted(segment& seg) -> std::optional<json::error> {
+        if (peek() == '*') {
+            m_pos++;
+            seg.selectors.push_back(selector{selector::kind::wildcard, {}, {}});
+            return std::nullopt;
+        }
+        auto name = parse_name();
+        if (!name) {
+            return fail("Expected a member name");
+        }
+        seg.selectors.push_back(selector{selector::kind::key, name_key(std::move(*name)), {}});
+        return std::nullopt;
+    }
+
+    // A quoted string in either kind of quote, with JSON's escapes
+    auto parse_string() -> json::result<std::string> {
+        const auto quote = m_s[m_pos];
+        auto text = std::string("\"");
+        for (m_pos++; m_pos < m_s.size() && m_s[m_pos] != quote; m_pos++) {
+            if (m_s[m_pos] == '\\' && m_pos + 1 < m_s.size()) {
+                if (m_s[m_pos + 1] == '\'') {
+                    text += '\'';
+                } else {
+                    text += m_s.substr(m_pos, 2);
+                }
+                m_pos++;
+            } else if (m_s[m_pos] == '"') {
+                text += "\\\"";
+            } else {
+                text += m_s[m_pos];
+            }
+        }
+        if (m_pos == m_s.size()) {
+            return fail("Unterminated string");
+        }
+        m_pos++;
+        text += '"';
+        // Decoded as the JSON string it would be with double quotes
+        auto lex = json::detail::lexer(text);
+        auto out = std::string();
+        if (lex.lex_string(out)) {
+            return fail("Invalid escape in string");
+        }
+        return out;
+    }
+
+    auto parse_int() -> std::optional<std::int64_t> {
+        const auto start = m_pos;
+        if (peek() == '-') {
+            m_pos++;
+        }
+        const auto digits = m_pos;
+        while (m_pos < m_s.size() && json::detail::lexer::is_int(m_s[m_pos])) {
+            m_pos++;
+        }
+        if (m_pos == digits || m_pos - start > 18) {
+            m_pos = start;
+            return std::nullopt;
+        }
+        return std::stoll(std::string(m_s.substr(start, m_pos - start)));
+    }
+
+    // `[` selectors separated by commas `]`
+    auto parse_bracket(segment& seg) -> std::optional<json::error> {
+        m_pos++;
+        while (true) {
+            skip_space();
+            const auto c = peek();
+            if (c == '*') {
+                m_pos++;
+                seg.selectors.push_back(selector{selector::kind::wildcard, {}, {}});
+            } else if (c == '\'' || c == '"') {
+                auto name = parse_string();
+                if (!name) {
+                    return std::move(name).error();
+                }
+                seg.selectors.push_back(selector{selector::kind::key, name_key(std::move(*name)), {}});
+            } else if (c == '?') {
+                m_pos++;
+                auto sel = selector{selector::kind::filter, {}, {}};
+                if (auto err = parse_filter(sel.filter)) {
+                    return err;
+                }
+                seg.selectors.push_back(std::move(sel));
+            } else if (auto i = parse_int()) {
+                seg.selectors.push_back(selector{selector::kind::key, index_key(*i), {}});
+            } else {
+                return fail("Expected a selector");
+            }
+            skip_space();
+            if (peek() == ']') {
+                m_pos++;
+                return std::nullopt;
+            }
+            if (peek() != ',') {
+                return fail("Expected ',' or ']'");
+            }
+            m_pos++;
+        }
+    }
+
+    // Comparisons joined by && within groups joined by ||, optionally in parentheses
+    auto parse_filter(std::vector<std::vector<comparison>>& filter) -> std::optional<json::error> {
+        skip_space();
+        const auto parens = peek() == '(';
+        if (parens) {
+            m_pos++;
+        }
+        filter.emplace_back();
+        while (true) {
+            auto c = comparison();
+            if (auto err = parse_comparison(c)) {
+                return err;
+            }
+            filter.back().push_back(std::move(c));
+            skip_space();
+            if (m_s.substr(m_pos, 2) == "&&") {
+                m_pos += 2;
+            } else if (m_s.substr(m_pos, 2) == "||") {
+                m_pos += 2;
+                filter.emplace_back();
+            } else {
+                break;
+            }
+        }
+        if (parens) {
+            if (peek() != ')') {
+                return fail("Expected ')'");
+            }
+            m_pos++;
+        }
+        return std::nullopt;
+    }
+
+    auto parse_comparison(comparison& c) -> std::optional<json::error> {
+        skip_space();
+        if (peek() != '@') {
+            return fail("Expected '@'");
+        }
+        m_pos++;
+        while (true) {
+            if (peek() == '.') {
+                m_pos++;
+                auto name = parse_name();
+                if (!name) {
+                    return fail("Expected a member name");
+                }
+                c.path.push_back(name_key(std::move(*name)));
+            } else if (peek() == '[') {
+                m_pos++;
+                skip_space();
+                if (peek() == '\'' || peek() == '"') {
+                    auto name = parse_string();
+                    if (!name) {
+                        return std::move(name).error();
+                    }
+                    c.path.push_back(name_key(std::move(*name)));
+                } else if (auto i = parse_int()) {
+                    c.path.push_back(index_key(*i));
+                } else {
+                    return fail("Expected a member name or index");
+                }
+                skip_space();
+                if (peek() != ']') {
+                    return fail("Expected ']'");
+                }
+                m_pos++;
+            } else {
+                break;
+            }
+        }
+        skip_space();
+        constexpr std::pair<std::string_view, comparison::op> ops[] = {
+        {"==", comparison::op::eq}, {"!=", comparison::op::ne}, {"<=", comparison::op::le},
+        {">=", comparison::op::ge}, {"<", comparison::op::lt}, {">", comparison::op::gt},
+        };
+        for (const auto& [text, op] : ops) {
+            if (m_s.substr(m_pos, text.size()) == text) {
+                m_pos += text.size();
+                c.oper = op;
+                skip_space();
+                return parse_literal(c.value);
+            }
+        }
+        c.oper = comparison::op::exists;
+        return std::nullopt;
+    }
+
+    auto parse_literal(literal& value) -> std::optional<json::error> {
+        if (peek() == '\'' || peek() == '"') {
+            auto s = parse_string();
+            if (!s) {
+                return std::move(s).error();
+            }
+            value = std::move(*s);
+            return std::nullopt;
+        }
+        auto end = m_pos;
+        while (end < m_s.size() && !json::detail::lexer::is_whitespace(m_s[end]) && std::string_view(")]&|,").find(m_s[end]) == std::string_view::npos) {
+            end++;
+        }
+        const auto scalar = end == m_pos ? std::nullopt : json::detail::scan_scalar(m_s.data() + m_pos, m_s.data() + end);
+        if (!scalar) {
+            return fail("Expected a literal");
+        }
+        m_pos = end;
+        value = std::visit([](auto x) { return literal(x); }, *scalar);
+        return std::nullopt;
+    }
+
+    std::string_view m_s;
+    std::size_t m_pos = 0;
+};
+
+}
+
+auto json::detail::compare(const std::optional<scalar_view>& lhs, comparison::op op, const literal& rhs) noexcept -> bool {
+    using enum comparison::op;
+    auto order = std::partial_ordering::unordered;
+    if (lhs) {
+        order = std::visit(overload{
+        [](null, null) { return std::partial_ordering::equivalent; },
+        [](bool a, bool b) { return a == b ? std::partial_ordering::equivalent : std::partial_ordering::unordered; },
+        [](std::string_view a, const std::string& b) -> std::partial_ordering { return a <=> std::string_view(b); },
+        [](std::int64_t a, std::int64_t b) -> std::partial_ordering { return a <=> b; },
+        []<class A, class B>(A a, B b) -> std::partial_ordering {
+            if constexpr ((std::same_as<A, std::int64_t> || std::same_as<A, double>) && (std::same_as<B, std::int64_t> || std::same_as<B, double>)) {
+                return double(a) <=> double(b);
+            } else {
+                return std::partial_ordering::unordered;
+            }
+        },
+        }, *lhs, rhs);
+    }
+    switch (op) {
+        case eq:
+            return order == 0;
+        case ne:
+            return order != 0;
+        case lt:
+            return order < 0;
+        case le:
+            return order <= 0;
+        case gt:
+            return order > 0;
+        case ge:
+            return order >= 0;
+        case exists:
+            break;
+    }
+    return true;
+}
+
+json::query_set::query_set(std::vector<query> queries) : m_queries(std::move(queries)), m_nodes(1) {
+    for (auto q = std::uint32_t(0); q < m_queries.size(); q++) {
+        const auto& segments = m_queries[q].m_segments;
+        auto n = std::uint32_t(0);
+        auto i = std::uint32_t(0);
+        for (; i < segments.size(); i++) {
+            const auto& seg = segments[i];
+            if (seg.descendant || seg.selectors.size() != 1 || seg.selectors[0].type != selector::kind::key) {
+                break;
+            }
+            const auto& key = seg.selectors[0].key;
+            auto& children = m_nodes[n].children;
+            const auto it = std::find_if(children.begin(), children.end(), [&key](const auto& c) {
+                return c.first.name == key.name && c.first.index == key.index;
+            });
+            if (it != children.end()) {
+                n = it->second;
+                continue;
+            }
+            const auto next = std::uint32_t(m_nodes.size());
+            children.emplace_back(key, next);
+            m_nodes.emplace_back();
+            n = next;
+        }
+        if (i == segments.size()) {
+            m_nodes[n].matches.push_back(q);
+        } else {
+            m_nodes[n].rest.emplace_back(q, i);
+        }
+    }
+}
+
+auto json::compile_query(std::string_view s) -> result<query> {
+    auto q = query();
+    auto segments = !s.empty() && s[0] == '$' ? path_parser(s).parse() : compile_pointer(s);
+    if (!segments) {
+        return std::move(segments).error();
+    }
+    q.m_segments = std::move(*segments);
+    return q;
+}
+
+}
@@ -0,0 +1,154 @@
+#include "../include/meejson/serializer.hpp"
+#include "../include/meejson/lexer.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace mee {
+
+namespace {
+
+// The character after the backslash for each byte that must be escaped, 'u' for those written
+// as \u00XX and 0 for bytes copied unchanged
+constexpr auto escapes = [] {
+    auto table = std::array<char, 256>{};
+    for (auto c = 0; c < 0x20; c++) {
+        table[std::size_t(c)] = 'u';
+    }
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    table['"'] = '"';
+    table['\\'] = '\\';
+    return table;
+}();
+
+// "00" through "99", so integers are written two digits per division
+constexpr auto digit_pairs = [] {
+    auto table = std::array<char, 200>{};
+    for (auto i = 0; i < 100; i++) {
+        table[std::size_t(2 * i)] = char('0' + i / 10);
+        table[std::size_t(2 * i + 1)] = char('0' + i % 10);
+    }
+    return table;
+}();
+
+// Writes the digits of `u` backwards, two at a time, ending at `last`. Returns the first digit.
+auto write_digits(std::uint64_t u, char* last) noexcept -> char* {
+    while (u >= 100) {
+        const auto pair = (u % 100) * 2;
+        u /= 100;
+        last -= 2;
+        std::memcpy(last, digit_pairs.data() + pair, 2);
+    }
+    if (u >= 10) {
+        last -= 2;
+        std::memcpy(last, digit_pairs.data() + u * 2, 2);
+    } else {
+        *--last = char('0' + u);
+    }
+    return last;
+}
+
+constexpr auto powers_of_ten = std::array{1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16};
+
+// Most floats in JSON are short decimals. If d * 10^p rounds to an integer m that divides back to
+// exactly d, then m with p decimals reads back as d, since the division and the parser both round
+// correctly. Trying p from 1 upwards finds the fewest decimals. Anything tiny, huge or needing
+// more than 2^53 as m is left to std::to_chars, as are large integers, which it writes as
+// exponents.
+auto dump_short_decimal(double d, std::string& out) -> bool {
+    const auto a = std::abs(d);
+    if (!(a >= 1e-3 && a < 1e15) || (a >= 1e7 && a == std::trunc(a))) {
+        return false;
+    }
+    for (auto p = std::size_t(1); p < powers_of_ten.size(); p++) {
+        const auto scaled = a * powers_of_ten[p];
+        if (scaled >= 9007199254740992.0) {
+            return false;
+        }
+        const auto m = std::uint64_t(scaled + 0.5);
+        if (double(m) / powers_of_ten[p] != a) {
+            continue;
+        }
+        char buf[24];
+        const auto last = buf + sizeof(buf);
+        auto first = write_digits(m, last);
+        const auto digits = std::size_t(last - first);
+        if (d < 0) {
+            out += '-';
+        }
+        if (digits <= p) {
+            out += "0.";
+            out.append(p - digits, '0');
+            out.append(first, last);
+        } else {
+            out.append(first, last - p);
+            out += '.';
+            out.append(last - p, last);
+        }
+        return true;
+    }
+    return false;
+}
+
+}
+
+void json::detail::dump_string(std::string_view s, std::string& out) {
+    constexpr auto hex = std::string_view("0123456789abcdef");
+    out += '"';
+    auto first = s.data();
+    const auto last = s.data() + s.size();
+    while (true) {
+        // Runs without anything to escape are found a block at a time and copied whole
+        const auto special = find_string_special(first, last);
+        out.append(first, special);
+        if (special == last) {
+            break;
+        }
+        const auto c = static_cast<unsigned char>(*special);
+        const auto e = escapes[c];
+        if (e == 'u') {
+            const char seq[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+            out.append(seq, sizeof(seq));
+        } else {
+            const char seq[] = {'\\', e};
+            out.append(seq, sizeof(seq));
+        }
+        first = special + 1;
+    }
+    out += '"';
+}
+
+void json::detail::dump_int(std::int64_t i, std::string& out) {
+    char buf[20];
+    auto first = write_digits(i < 0 ? std::uint64_t(0) - std::uint64_t(i) : std::uint64_t(i), buf + sizeof(buf));
+    if (i < 0) {
+        *--first = '-';
+    }
+    out.append(first, buf + sizeof(buf));
+}
+
+void json::detail::dump_float(double d, std::string& out) {
+    if (!std::isfinite(d)) {
+        out += "null";
+        return;
+    }
+    if (dump_short_decimal(d, out)) {
+        return;
+    }
+    // The shortest digits that read back as the same double
+    char buf[32];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), d);
+    out.append(buf, res.ptr);
+    // Keep integral floats floats when read back
+    if (std::find_if(buf, res.ptr, [](char c) { return c == '.' || c == 'e'; }) == res.ptr) {
+        out += ".0";
+    }
+}
+
+}
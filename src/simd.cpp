@@ -0,0 +1,247 @@
+#include "../include/meejson/lexer.hpp"
+#include <bit>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define MEEJSON_X86_64 1
+#endif
+
+namespace mee {
+
+namespace {
+
+// Bitmasks over a 64 byte block, bit i describing byte i
+struct block {
+    std::uint64_t backslash;
+    std::uint64_t quote;
+    std::uint64_t op;
+    std::uint64_t whitespace;
+};
+
+using classify_fn = auto (*)(const char*) noexcept -> block;
+
+[[maybe_unused]] auto classify_scalar(const char* p) noexcept -> block {
+    auto b = block{};
+    for (auto i = 0; i < 64; i++) {
+        const auto bit = std::uint64_t(1) << i;
+        switch (p[i]) {
+            case '\\':
+                b.backslash |= bit;
+                break;
+            case '"':
+                b.quote |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                b.op |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                b.whitespace |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+    return b;
+}
+
+#ifdef MEEJSON_X86_64
+
+// '[' and ']' differ from '{' and '}' only in bit 0x20, so or-ing it in halves the comparisons
+auto classify_sse2(const char* p) noexcept -> block {
+    auto b = block{};
+    for (auto i = 0; i < 64; i += 16) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const auto eq = [v](char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); };
+        const auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        const auto brace = _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}')));
+        const auto op = _mm_or_si128(brace, _mm_or_si128(eq(':'), eq(',')));
+        const auto ws = _mm_or_si128(_mm_or_si128(eq(' '), eq('\t')), _mm_or_si128(eq('\n'), eq('\r')));
+        const auto mask = [](__m128i m) { return std::uint64_t(std::uint16_t(_mm_movemask_epi8(m))); };
+        b.backslash |= mask(eq('\\')) << i;
+        b.quote |= mask(eq('"')) << i;
+        b.op |= mask(op) << i;
+        b.whitespace |= mask(ws) << i;
+    }
+    return b;
+}
+
+__attribute__((target("avx2")))
+auto classify_avx2(const char* p) noexcept -> block {
+    auto b = block{};
+    for (auto i = 0; i < 64; i += 32) {
+        const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const auto eq = [v](char c) __attribute__((target("avx2"))) {
+            return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+        };
+        const auto lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        const auto brace = _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')),
+                                           _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}')));
+        const auto op = _mm256_or_si256(brace, _mm256_or_si256(eq(':'), eq(',')));
+        const auto ws = _mm256_or_si256(_mm256_or_si256(eq(' '), eq('\t')), _mm256_or_si256(eq('\n'), eq('\r')));
+        const auto mask = [](__m256i m) __attribute__((target("avx2"))) {
+            return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(m)));
+        };
+        b.backslash |= mask(eq('\\')) << i;
+        b.quote |= mask(eq('"')) << i;
+        b.op |= mask(op) << i;
+        b.whitespace |= mask(ws) << i;
+    }
+    return b;
+}
+
+#endif
+
+// First byte in [first, last) that ends a run of plain string characters: a quote, a backslash or
+// a control character
+using find_special_fn = auto (*)(const char*, const char*) noexcept -> const char*;
+
+auto is_string_special(char c) noexcept -> bool {
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+auto find_special_scalar(const char* first, const char* last) noexcept -> const char* {
+    while (first != last && !is_string_special(*first)) {
+        first++;
+    }
+    return first;
+}
+
+#ifdef MEEJSON_X86_64
+
+// max(c, 0x1F) == 0x1F picks out the control characters, as there is no unsigned byte compare
+auto find_special_sse2(const char* first, const char* last) noexcept -> const char* {
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto control = _mm_set1_epi8(0x1F);
+    for (; last - first >= 16; first += 16) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const auto special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                          _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+        if (const auto mask = _mm_movemask_epi8(special)) {
+            return first + std::countr_zero(std::uint32_t(mask));
+        }
+    }
+    return find_special_scalar(first, last);
+}
+
+__attribute__((target("avx2")))
+auto find_special_avx2(const char* first, const char* last) noexcept -> const char* {
+    const auto quote = _mm256_set1_epi8('"');
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto control = _mm256_set1_epi8(0x1F);
+    for (; last - first >= 32; first += 32) {
+        const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const auto special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                                             _mm256_cmpeq_epi8(_mm256_max_epu8(v, control), control));
+        if (const auto mask = _mm256_movemask_epi8(special)) {
+            return first + std::countr_zero(std::uint32_t(mask));
+        }
+    }
+    return find_special_sse2(first, last);
+}
+
+#endif
+
+auto select_find_special() noexcept -> find_special_fn {
+#ifdef MEEJSON_X86_64
+    if (__builtin_cpu_supports("avx2")) {
+        return find_special_avx2;
+    }
+    return find_special_sse2;
+#else
+    return find_special_scalar;
+#endif
+}
+
+auto select_classifier() noexcept -> classify_fn {
+#ifdef MEEJSON_X86_64
+    if (__builtin_cpu_supports("avx2")) {
+        return classify_avx2;
+    }
+    return classify_sse2;
+#else
+    return classify_scalar;
+#endif
+}
+
+// Bit i of the result is the xor of bits 0..i
+constexpr auto prefix_xor(std::uint64_t x) noexcept -> std::uint64_t {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Marks the characters escaped by a backslash, i.e. those following an odd length run of them.
+// `prev_escaped` carries whether the first byte of the next block is escaped.
+constexpr auto find_escaped(std::uint64_t backslash, std::uint64_t& prev_escaped) noexcept -> std::uint64_t {
+    constexpr auto even_bits = std::uint64_t(0x5555555555555555);
+    backslash &= ~prev_escaped;
+    const auto follows_escape = (backslash << 1) | prev_escaped;
+    const auto odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+    const auto sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+    prev_escaped = sequences_starting_on_even_bits < backslash;
+    const auto invert_mask = sequences_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+}
+
+auto json::detail::find_string_special(const char* first, const char* last) noexcept -> const char* {
+    static const auto find_special = select_find_special();
+    return find_special(first, last);
+}
+
+auto json::detail::index_structurals(std::string_view s) -> std::vector<std::uint32_t> {
+    static const auto classify = select_classifier();
+
+    auto index = std::vector<std::uint32_t>();
+    index.reserve(s.size() / 4);
+    auto prev_escaped = std::uint64_t(0);
+    auto prev_in_string = std::uint64_t(0);
+    auto prev_scalar = std::uint64_t(0);
+    char padded[64];
+    for (auto offset = std::size_t(0); offset < s.size(); offset += 64) {
+        const char* p = s.data() + offset;
+        if (s.size() - offset < 64) {
+            std::memset(padded, ' ', sizeof(padded));
+            std::memcpy(padded, p, s.size() - offset);
+            p = padded;
+        }
+        const auto b = classify(p);
+        const auto escaped = find_escaped(b.backslash, prev_escaped);
+        const auto quote = b.quote & ~escaped;
+        const auto in_string = prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = std::uint64_t(std::int64_t(in_string) >> 63);
+
+        // A scalar starts wherever a non whitespace, non structural byte follows one that is not
+        // part of the same scalar. Opening quotes count, string contents and closing quotes don't.
+        const auto scalar = ~(b.op | b.whitespace);
+        const auto nonquote_scalar = scalar & ~quote;
+        const auto follows_nonquote_scalar = (nonquote_scalar << 1) | prev_scalar;
+        prev_scalar = nonquote_scalar >> 63;
+        auto starts = (b.op | (scalar & ~follows_nonquote_scalar)) & ~(in_string ^ quote);
+
+        auto n = index.size();
+        index.resize(n + std::size_t(std::popcount(starts)));
+        while (starts) {
+            index[n++] = std::uint32_t(offset + std::size_t(std::countr_zero(starts)));
+            starts &= starts - 1;
+        }
+    }
+    return index;
+}
+
+}
@@ -0,0 +1,269 @@
+#include "../include/meejson/stream.hpp"
+#include "../include/meejson/projection.hpp"
+#include "../include/meejson/sax.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <thread>
+
+namespace mee {
+
+namespace {
+
+using json::detail::dom_builder;
+using json::detail::lexer;
+using json::detail::projecting_handler;
+using json::detail::sax_parser;
+
+struct batch {
+    // Errors count lines and columns from here, which is always the start of a line
+    std::size_t base = 0;
+    // Where the first value was expected to start
+    std::size_t first = 0;
+    std::vector<json::result<json::value>> results;
+    // Where the value after the batch starts, or the end of input
+    std::size_t stop = 0;
+};
+
+auto skip_space(std::string_view s, std::size_t offset) noexcept -> std::size_t {
+    while (offset < s.size() && lexer::is_whitespace(s[offset])) {
+        offset++;
+    }
+    return offset;
+}
+
+// Parses one value after another, building only the fields asked for if the options name any
+struct value_parser {
+    value_parser(const lexer& lex, const json::parse_options& options) noexcept {
+        if (options.fields) {
+            m_projector.emplace(m_builder, *options.fields);
+            m_projected.emplace(lex, *m_projector, options);
+        } else {
+            m_plain.emplace(lex, m_builder, options);
+        }
+    }
+
+    value_parser(const value_parser&) = delete;
+    auto operator=(const value_parser&) -> value_parser& = delete;
+
+    auto get_lexer() noexcept -> lexer& {
+        return m_plain ? m_plain->get_lexer() : m_projected->get_lexer();
+    }
+
+    auto parse_next() -> json::result<json::value> {
+        m_builder = dom_builder<json::value>();
+        if (m_projector) {
+            // Drops anything left open by a value that failed
+            m_projector.emplace(m_builder, m_projector->fields());
+        }
+        if (auto err = m_plain ? m_plain->parse_next() : m_projected->parse_next()) {
+            return std::move(*err);
+        }
+        return m_builder.take();
+    }
+
+private:
+    dom_builder<json::value> m_builder;
+    std::optional<projecting_handler<dom_builder<json::value>>> m_projector;
+    std::optional<sax_parser<dom_builder<json::value>>> m_plain;
+    std::optional<sax_parser<projecting_handler<dom_builder<json::value>>>> m_projected;
+};
+
+// Parses the values starting in [first, limit). Only the batch is indexed; the last value may carry
+// on past `limit`, in which case it fails against the index and is parsed again from the whole rest
+// of the input. After a value fails the index can't be trusted either, since an unterminated
+// string turns everything after it inside out, so the rest of the batch is lexed without it.
+// Each result is passed to `sink`, which returns whether to carry on. Returns where the value after
+// the batch starts, or nothing if the sink stopped.
+template <class Sink>
+auto parse_batch(std::string_view s, std::size_t base, std::size_t first, std::size_t limit, const json::parse_options& options,
+                 Sink&& sink) -> std::optional<std::size_t> {
+    const auto region = s.substr(base, limit - base);
+    const auto indexed = region.size() <= std::numeric_limits<std::uint32_t>::max();
+    const auto index = indexed ? json::detail::index_structurals(region) : std::vector<std::uint32_t>();
+    auto parser = value_parser(indexed ? lexer(region, index) : lexer(region), options);
+    auto rest = value_parser(lexer(s.substr(base)), options);
+
+    auto current = &parser;
+    current->get_lexer().seek(first - base);
+    while (current->get_lexer().skip_whitespace()) {
+        const auto start = current->get_lexer().offset();
+        if (base + start >= limit) {
+            break;
+        }
+        auto res = current->parse_next();
+        auto end = current->get_lexer().offset();
+        if (!res && current == &parser && limit < s.size()) {
+            rest.get_lexer().seek(start);
+            res = rest.parse_next();
+            end = rest.get_lexer().offset();
+        }
+        if (!res) {
+            // Carry on from the line after the one the value started on, so a value cut short
+            // doesn't take the next one with it
+            const auto line_end = s.find('\n', base + start);
+            end = line_end == std::string_view::npos ? s.size() - base : line_end + 1 - base;
+            current = &rest;
+        }
+        if (!sink(std::move(res))) {
+            return std::nullopt;
+        }
+        if (base + end >= limit) {
+            return skip_space(s, base + end);
+        }
+        current->get_lexer().seek(end);
+    }
+    return current == &parser ? skip_space(s, limit) : base + current->get_lexer().offset();
+}
+
+// Parses batches ahead of the thread taking them, keeping at most two per thread waiting. Waiting
+// is done on atomics, so an idle side sleeps rather than spins.
+struct batch_pool {
+    batch_pool(std::string_view s, const std::vector<std::size_t>& starts, const json::parse_options& options, std::size_t threads)
+    : m_text(s), m_starts(starts), m_options(options), m_slots(2 * threads) {
+        for (auto i = std::size_t(0); i < threads; i++) {
+            m_threads.emplace_back([this] { work(); });
+        }
+    }
+
+    batch_pool(const batch_pool&) = delete;
+    auto operator=(const batch_pool&) -> batch_pool& = delete;
+
+    ~batch_pool() {
+        m_stop = true;
+        // Wake any thread waiting for room
+        m_taken += m_slots.size();
+        m_taken.notify_all();
+        for (auto& t : m_threads) {
+            t.join();
+        }
+    }
+
+    // Waits for batch `i`. Batches must be taken in order.
+    auto take(std::size_t i) -> batch {
+        auto& slot = m_slots[i % m_slots.size()];
+        for (auto filled = slot.filled.load(); filled != i + 1; filled = slot.filled.load()) {
+            slot.filled.wait(filled);
+        }
+        auto b = std::move(slot.value);
+        m_taken++;
+        m_taken.notify_all();
+        return b;
+    }
+
+private:
+    struct slot {
+        batch value;
+        // One more than the index of the batch held
+        std::atomic<std::size_t> filled = 0;
+    };
+
+    void work() {
+        const auto batches = m_starts.size() - 1;
+        while (true) {
+            const auto i = m_next++;
+            if (i >= batches) {
+                return;
+            }
+            for (auto taken = m_taken.load(); !m_stop && i >= taken + m_slots.size(); taken = m_taken.load()) {
+                m_taken.wait(taken);
+            }
+            if (m_stop) {
+                return;
+            }
+            auto& slot = m_slots[i % m_slots.size()];
+            const auto first = skip_space(m_text, m_starts[i]);
+            slot.value = batch{m_starts[i], first, {}, 0};
+            slot.value.stop = *parse_batch(m_text, m_starts[i], first, m_starts[i + 1], m_options, [&slot](json::result<json::value>&& res) {
+                slot.value.results.push_back(std::move(res));
+                return true;
+            });
+            slot.filled = i + 1;
+            slot.filled.notify_all();
+        }
+    }
+
+    std::string_view m_text;
+    const std::vector<std::size_t>& m_starts;
+    json::parse_options m_options;
+
+    std::vector<slot> m_slots;
+    std::atomic<std::size_t> m_next = 0;
+    std::atomic<std::size_t> m_taken = 0;
+    std::atomic<bool> m_stop = false;
+    std::vector<std::thread> m_threads;
+};
+
+}
+
+void json::parse_many(std::string_view s, const std::function<bool(result<value>&&)>& handler, const parse_many_options& options) {
+    // Batch i holds [starts[i], starts[i + 1]), each starting just after a line break
+    auto starts = std::vector<std::size_t>{0};
+    const auto batch_size = std::max(options.batch_size, std::size_t(1));
+    while (s.size() - starts.back() > batch_size) {
+        const auto line_end = s.find('\n', starts.back() + batch_size);
+        if (line_end == std::string_view::npos || line_end + 1 == s.size()) {
+            break;
+        }
+        starts.push_back(line_end + 1);
+    }
+    starts.push_back(s.size());
+    const auto batches = starts.size() - 1;
+
+    const auto threads = options.threads ? options.threads : std::size_t(std::max(std::thread::hardware_concurrency(), 1u));
+    auto pool = std::optional<batch_pool>();
+    if (threads > 1 && batches > 1) {
+        pool.emplace(s, starts, options.parse, std::min(threads, batches));
+    }
+
+    // Lines are only counted once an error needs them
+    auto counted = std::size_t(0);
+    auto lines = std::int32_t(0);
+    auto deliver = [&](std::size_t base, result<value>&& res) {
+        if (!res) {
+            lines += std::int32_t(std::count(s.begin() + std::ptrdiff_t(counted), s.begin() + std::ptrdiff_t(base), '\n'));
+            counted = base;
+            res.error().line += lines;
+        }
+        return handler(std::move(res));
+    };
+
+    auto expected = skip_space(s, 0);
+    for (auto i = std::size_t(0); i < batches; i++) {
+        auto b = pool ? std::optional(pool->take(i)) : std::nullopt;
+        if (expected >= starts[i + 1]) {
+            // The last value of an earlier batch ran over the whole of this one
+            continue;
+        }
+        if (b && b->first == expected) {
+            for (auto& res : b->results) {
+                if (!deliver(b->base, std::move(res))) {
+                    return;
+                }
+            }
+            expected = b->stop;
+            continue;
+        }
+        // Without threads, or when the guess was wrong, values are handed over as they are parsed
+        const auto stop = parse_batch(s, starts[i], expected, starts[i + 1], options.parse, [&deliver, base = starts[i]](result<value>&& res) {
+            return deliver(base, std::move(res));
+        });
+        if (!stop) {
+            return;
+        }
+        expected = *stop;
+    }
+}
+
+auto json::parse_many(std::string_view s, const parse_many_options& options) -> std::vector<result<value>> {
+    auto results = std::vector<result<value>>();
+    parse_many(s, [&results](result<value>&& res) {
+        results.push_back(std::move(res));
+        return true;
+    }, options);
+    return results;
+}
+
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/compact.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+// Structural equality across the two value flavours
+auto same(const json::value& lhs, const json::compact::value& rhs) -> bool {
+    if (lhs.type_name() != rhs.type_name()) {
+        return false;
+    }
+    if (auto arr = lhs.get_if_array()) {
+        const auto& other = rhs.get_array();
+        return std::equal(arr->begin(), arr->end(), other.begin(), other.end(), same);
+    }
+    if (auto obj = lhs.get_if_object()) {
+        const auto& other = rhs.get_object();
+        return obj->size() == other.size() && std::all_of(obj->begin(), obj->end(), [&other](auto ref) {
+            const auto& [key, val] = ref;
+            auto it = other.find(json::compact::string(key));
+            return it != other.end() && same(val, it->second());
+        });
+    }
+    if (auto s = lhs.get_if_string()) {
+        return std::string_view(*s) == std::string_view(rhs.get_string());
+    }
+    return json::visit([&rhs](const auto& x) {
+        return json::visit(json::detail::overload{
+            [&x](const decltype(x)& y) { return x == y; },
+            [](const auto&) { return false; },
+        }, rhs);
+    }, lhs);
+}
+
+}
+
+static_assert(sizeof(json::compact::string) == sizeof(void*));
+static_assert(sizeof(json::compact::value) == 2 * sizeof(void*));
+
+TEST(compact_test, string) {
+    for (auto len : {0, 1, 7, 8, 15, 16, 100}) {
+        const auto text = std::string(std::size_t(len), 'x');
+        auto s = json::compact::string(text);
+        ASSERT_EQ(s.size(), text.size());
+        ASSERT_EQ(std::string_view(s), text);
+        ASSERT_EQ(s.empty(), len == 0);
+
+        auto copy = s;
+        ASSERT_EQ(copy, s);
+        ASSERT_NE(copy.data(), s.data());
+
+        auto moved = std::move(copy);
+        ASSERT_EQ(moved, s);
+        ASSERT_TRUE(copy.empty());
+
+        copy = moved;
+        ASSERT_EQ(copy, s);
+        moved = json::compact::string("short");
+        ASSERT_EQ(std::string_view(moved), "short"sv);
+    }
+    ASSERT_LT(json::compact::string("abc"), json::compact::string("abd"));
+    ASSERT_LT(json::compact::string("abcdefgh"), json::compact::string("abcdefghi"));
+    ASSERT_EQ(std::string_view(json::compact::string("a\0b"sv)), "a\0b"sv);
+
+    auto set = std::unordered_set<json::compact::string>{"one", "a much longer string"};
+    ASSERT_TRUE(set.contains("one"));
+    ASSERT_TRUE(set.contains("a much longer string"));
+    ASSERT_FALSE(set.contains("two"));
+}
+
+TEST(compact_test, value) {
+    using value = json::compact::value;
+    auto val = value(json::compact::object());
+    val.emplace("name", value("compact"));
+    val.emplace("sizes", value{value(8), value(16), value(2.5)});
+    val.emplace("ok", value(true));
+    ASSERT_TRUE(val.has_key("sizes"));
+    ASSERT_FALSE(val.has_key("size"));
+    ASSERT_EQ(std::string_view(val["name"].get_string()), "compact"sv);
+    ASSERT_EQ(val["sizes"][1].get_int(), 16);
+    ASSERT_EQ(val["sizes"][2].get_float(), 2.5);
+    ASSERT_TRUE(val["ok"].get_bool());
+
+    auto copy = val;
+    copy["name"] = json::compact::string("changed");
+    ASSERT_EQ(std::string_view(val["name"].get_string()), "compact"sv);
+}
+
+TEST(compact_test, parse) {
+    constexpr auto s = R"([{"id": 1, "name": "short", "tags": ["a", "tag longer than a word"],
+                           "score": -2.5e3, "été": null, "nested": {"ok": true, "list": []}}])"sv;
+    auto compact = json::parse<json::compact::value>(s);
+    ASSERT_TRUE(compact);
+    ASSERT_TRUE(same(*json::parse(s), *compact));
+    ASSERT_EQ(std::string_view((*compact)[0]["tags"][1].get_string()), "tag longer than a word"sv);
+
+    auto err = json::parse<json::compact::value>(R"({"a": [1, 2})");
+    ASSERT_FALSE(err);
+    ASSERT_EQ(err.error().what(), json::parse(R"({"a": [1, 2})").error().what());
+}
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/cursor.hpp"
+#include "../include/meejson/parser.hpp"
+
+#include <vector>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+constexpr auto text = R"({
+    "id": 42,
+    "name": "widget",
+    "price": 9.5,
+    "escaped": "a\"bé",
+    "tags": ["x", "y", "z"],
+    "dims": {"w": 1, "h": [2, 3], "d": {}},
+    "empty": [],
+    "ok": true,
+    "none": null
+})"sv;
+
+}
+
+TEST(cursor_test, access) {
+    auto c = json::cursor(text);
+    const auto root = c.root();
+
+    EXPECT_EQ(root.type_name(), "object");
+    EXPECT_EQ(c["id"].get_int(), 42);
+    EXPECT_EQ(c["id"].type_name(), "integer");
+    EXPECT_EQ(c["name"].get_string(), "widget"sv);
+    EXPECT_EQ(c["price"].get_float(), 9.5);
+    EXPECT_EQ(c["escaped"].get_string(), "a\"b\xC3\xA9"sv);
+    EXPECT_EQ(c["tags"][2].get_string(), "z"sv);
+    EXPECT_EQ(c["dims"]["h"][1].get_int(), 3);
+    EXPECT_TRUE(c["dims"]["d"].get_object().empty());
+    EXPECT_TRUE(c["empty"].get_array().empty());
+    EXPECT_TRUE(c["ok"].get_bool());
+    EXPECT_TRUE(c["none"].is_null());
+    EXPECT_TRUE(root.has_key("dims"));
+    EXPECT_FALSE(root.has_key("missing"));
+
+    // Lookups out of order wrap round to the start of the object
+    EXPECT_EQ(c["price"].get_float(), 9.5);
+    EXPECT_EQ(c["id"].get_int(), 42);
+    const auto dims = c["dims"];
+    EXPECT_EQ(dims["h"][0].get_int(), 2);
+    EXPECT_EQ(dims["w"].get_int(), 1);
+
+    EXPECT_FALSE(c["id"].get_if_float());
+    EXPECT_FALSE(c["name"].get_if_int());
+    EXPECT_FALSE(c["ok"].get_if_int());
+    EXPECT_EQ(c["price"].get_if_float(), 9.5);
+
+    EXPECT_THROW(c["missing"], json::invalid_access);
+    EXPECT_THROW(c["tags"][3], json::invalid_access);
+    EXPECT_THROW(static_cast<void>(c["id"].get_string()), json::invalid_operation);
+    EXPECT_THROW(c["tags"]["x"], json::invalid_operation);
+}
+
+TEST(cursor_test, iteration) {
+    auto c = json::cursor(text);
+    const auto root = c.root();
+
+    auto keys = std::vector<std::string_view>();
+    for (const auto member : root.get_object()) {
+        keys.push_back(member.first());
+    }
+    const auto expected = std::vector{"id"sv, "name"sv, "price"sv, "escaped"sv, "tags"sv, "dims"sv, "empty"sv, "ok"sv, "none"sv};
+    EXPECT_EQ(keys, expected);
+    EXPECT_EQ(root.get_object().size(), 9u);
+
+    auto tags = std::string();
+    for (const auto tag : c["tags"].get_array()) {
+        tags += tag.get_string();
+    }
+    EXPECT_EQ(tags, "xyz");
+    EXPECT_EQ(c["tags"].get_array().size(), 3u);
+
+    auto sum = std::int64_t(0);
+    auto rows = json::cursor(R"([{"v": 1, "s": "a]"}, {"s": "{", "v": 2}, {"v": 3}])");
+    for (const auto row : rows.root().get_array()) {
+        sum += row["v"].get_int();
+    }
+    EXPECT_EQ(sum, 6);
+}
+
+TEST(cursor_test, source) {
+    auto c = json::cursor(text);
+    EXPECT_EQ(c["dims"].source(), R"({"w": 1, "h": [2, 3], "d": {}})"sv);
+    EXPECT_EQ(c["price"].source(), "9.5"sv);
+    EXPECT_EQ(c["escaped"].source(), R"("a\"bé")"sv);
+}
+
+TEST(cursor_test, errors) {
+    // Errors met while reading are those the parser reports
+    const auto cases = std::vector<std::pair<std::string_view, void (*)(json::cursor&)>>{
+        {"  "sv, [](json::cursor& c) { static_cast<void>(c.root()); }},
+        {"[1, 2"sv, [](json::cursor& c) { c.root()[5]; }},
+        {"[1 2]"sv, [](json::cursor& c) { c.root()[1]; }},
+        {"[1,]"sv, [](json::cursor& c) { c.root()[1]; }},
+        {"[}"sv, [](json::cursor& c) { c.root()[0]; }},
+        {R"({"a" 1})"sv, [](json::cursor& c) { c["a"]; }},
+        {R"({1: 2})"sv, [](json::cursor& c) { c["a"]; }},
+        {R"({"a": "b)"sv, [](json::cursor& c) { static_cast<void>(c["a"].get_string()); }},
+        {R"({"a": -})"sv, [](json::cursor& c) { static_cast<void>(c["a"].get_int()); }},
+    };
+    for (const auto& [s, read] : cases) {
+        const auto full = json::parse(s);
+        ASSERT_FALSE(full) << s;
+        auto c = json::cursor(s);
+        try {
+            read(c);
+            ADD_FAILURE() << s;
+        } catch (const json::error_exception& e) {
+            EXPECT_EQ(e.what(), full.error().what()) << s;
+        }
+    }
+
+    // Scalars are only checked when they are read
+    auto c = json::cursor("[1, tru, 3, 1x]");
+    EXPECT_EQ(c.root()[2].get_int(), 3);
+    EXPECT_THROW(static_cast<void>(c.root()[1].get_bool()), json::error_exception);
+    EXPECT_THROW(static_cast<void>(c.root()[3].get_int()), json::error_exception);
+}
@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/document.hpp"
+
+#include <algorithm>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+// Structural equality across value flavours
+template <class Other>
+auto same(const json::value& lhs, const Other& rhs) -> bool {
+    if (lhs.type_name() != rhs.type_name()) {
+        return false;
+    }
+    if (auto arr = lhs.get_if_array()) {
+        const auto& other = rhs.get_array();
+        return std::equal(arr->begin(), arr->end(), other.begin(), other.end(), same<Other>);
+    }
+    if (auto obj = lhs.get_if_object()) {
+        const auto& other = rhs.get_object();
+        return obj->size() == other.size() && std::all_of(obj->begin(), obj->end(), [&other](auto ref) {
+            const auto& [key, val] = ref;
+            auto it = other.find(std::string_view(key));
+            return it != other.end() && same(val, it->second());
+        });
+    }
+    if (auto s = lhs.get_if_string()) {
+        return std::string_view(*s) == std::string_view(rhs.get_string());
+    }
+    return json::visit([&rhs](const auto& x) {
+        return json::visit(json::detail::overload{
+            [&x](const decltype(x)& y) { return x == y; },
+            [](const auto&) { return false; },
+        }, rhs);
+    }, lhs);
+}
+
+// Counts what reaches the default resource, which is where anything not taken from the arena goes
+struct counting_resource : std::pmr::memory_resource {
+    std::size_t allocations = 0;
+
+private:
+    auto do_allocate(std::size_t bytes, std::size_t align) -> void* override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override {
+        return this == &other;
+    }
+};
+
+const auto inputs = std::array{
+    "null"sv,
+    "-12"sv,
+    "2.5e10"sv,
+    R"("a string too long for the small string buffer")"sv,
+    "[]"sv,
+    "{}"sv,
+    R"([1, "two", 3.0, [true, false, null], {"a": {"b": ["c"]}}])"sv,
+    R"({"name": "a fairly long name that will not fit inline", "tags": ["x", "y"], "n": {"": 0}})"sv,
+};
+
+}
+
+TEST(document_test, matches_value) {
+    for (const auto s : inputs) {
+        auto val = json::parse(s);
+        auto doc = json::parse_document(s);
+        ASSERT_TRUE(val);
+        ASSERT_TRUE(doc);
+        EXPECT_TRUE(same(*val, doc->root()));
+    }
+}
+
+TEST(document_test, allocates_from_arena) {
+    auto counter = counting_resource();
+    auto previous = std::pmr::set_default_resource(&counter);
+    {
+        auto doc = json::parse_document(inputs[7]);
+        ASSERT_TRUE(doc);
+        EXPECT_EQ((*doc)->get_object().size(), 3u);
+        EXPECT_EQ(std::string_view((*doc)->get_object().at("tags")[1].get_string()), "y"sv);
+    }
+    std::pmr::set_default_resource(previous);
+    EXPECT_EQ(counter.allocations, 0u);
+}
+
+TEST(document_test, moves) {
+    auto doc = json::parse_document(R"({"a": [1, 2, 3]})");
+    ASSERT_TRUE(doc);
+    auto moved = std::move(*doc);
+    EXPECT_EQ(moved->get_object().at("a").get_array().size(), 3u);
+    doc = json::parse_document("[]");
+    ASSERT_TRUE(doc);
+    moved = std::move(*doc);
+    EXPECT_TRUE(moved->get_array().empty());
+}
+
+TEST(document_test, errors) {
+    EXPECT_FALSE(json::parse_document(""));
+    EXPECT_FALSE(json::parse_document("[1, 2"));
+    EXPECT_FALSE(json::parse_document(R"({"a" 1})"));
+    EXPECT_FALSE(json::parse_document("[[[]]]", {.max_depth = 2}));
+}
+
+TEST(document_test, default_value_unchanged) {
+    // The allocator is only stored when it has state
+    static_assert(sizeof(json::detail::box<json::array>) == sizeof(void*));
+    static_assert(sizeof(json::value) == sizeof(std::variant<std::string, void*>));
+}
+
+TEST(document_test, views) {
+    for (const auto s : inputs) {
+        auto val = json::parse(s);
+        auto doc = json::parse_view_document(s);
+        ASSERT_TRUE(val);
+        ASSERT_TRUE(doc);
+        EXPECT_TRUE(same(*val, doc->root()));
+    }
+
+    // Only strings with escapes are copied out of the text
+    const auto s = R"({"plain": "abc", "escaped": "a\tb\u00e9", "k\"ey": ""})"s;
+    auto doc = json::parse_view_document(s);
+    ASSERT_TRUE(doc);
+    const auto& obj = (*doc)->get_object();
+    const auto in_source = [&s](std::string_view v) {
+        return v.data() >= s.data() && v.data() + v.size() <= s.data() + s.size();
+    };
+    EXPECT_TRUE(in_source(obj.at("plain").get_string()));
+    EXPECT_EQ(obj.at("escaped").get_string(), "a\tb\xC3\xA9"sv);
+    EXPECT_FALSE(in_source(obj.at("escaped").get_string()));
+    EXPECT_TRUE(in_source(obj.find("plain")->first()));
+    EXPECT_EQ(obj.at("k\"ey").get_string(), ""sv);
+    EXPECT_FALSE(in_source(obj.find("k\"ey")->first()));
+}
+
+TEST(document_test, views_allocate_from_arena) {
+    auto counter = counting_resource();
+    auto previous = std::pmr::set_default_resource(&counter);
+    {
+        auto doc = json::parse_view_document(R"({"name": "a fairly long name that will not fit inline", "esc": "\n\n", "tags": ["x"]})");
+        ASSERT_TRUE(doc);
+        EXPECT_EQ((*doc)->get_object().at("esc").get_string(), "\n\n"sv);
+    }
+    std::pmr::set_default_resource(previous);
+    EXPECT_EQ(counter.allocations, 0u);
+}
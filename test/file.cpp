@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/file.hpp"
+
+#include <fstream>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+// A file in the temporary directory, removed again at the end of the test
+struct temp_file {
+    temp_file(std::string_view name, std::string_view contents)
+    : path(std::filesystem::temp_directory_path() / ("meejson_" + std::string(name) + ".json")) {
+        auto out = std::ofstream(path, std::ios::binary);
+        out.write(contents.data(), std::streamsize(contents.size()));
+    }
+
+    ~temp_file() {
+        std::filesystem::remove(path);
+    }
+
+    std::filesystem::path path;
+};
+
+}
+
+TEST(file_test, parse) {
+    constexpr auto s = R"({"a": [1, 2.5, "x\ty"], "b": {"c": null}})"sv;
+    const auto file = temp_file("parse", s);
+
+    auto mapped = json::map_file(file.path);
+    ASSERT_TRUE(mapped);
+    EXPECT_EQ(std::string_view(*mapped), s);
+    auto moved = std::move(*mapped);
+    EXPECT_EQ(std::string_view(moved), s);
+
+    auto val = json::parse_file(file.path);
+    ASSERT_TRUE(val) << val.error().what();
+    EXPECT_EQ(*val, *json::parse(s));
+
+    auto doc = json::parse_document_file(file.path);
+    ASSERT_TRUE(doc) << doc.error().what();
+    EXPECT_EQ(json::dump(doc->root()), json::dump(*val));
+}
+
+TEST(file_test, errors) {
+    auto missing = json::parse_file(std::filesystem::temp_directory_path() / "meejson_missing_file.json");
+    ASSERT_FALSE(missing);
+    EXPECT_TRUE(missing.error().msg.starts_with("File Error: Unable to open")) << missing.error().msg;
+
+    const auto empty = temp_file("empty", "");
+    auto val = json::parse_file(empty.path);
+    ASSERT_FALSE(val);
+    EXPECT_EQ(val.error().msg, "Parser Error: Unable to parse empty string");
+
+    const auto invalid = temp_file("invalid", "[1, 2");
+    EXPECT_FALSE(json::parse_file(invalid.path));
+}
+
+TEST(file_test, view_document) {
+    constexpr auto s = R"({"a": ["plain", "esc\"aped"], "b": 1})"sv;
+    auto doc = [&s] {
+        const auto file = temp_file("view", s);
+        return json::parse_view_document_file(file.path);
+    }();
+    // The mapping outlives the file's name
+    ASSERT_TRUE(doc) << doc.error().what();
+    const auto& arr = (*doc)->get_object().at("a").get_array();
+    EXPECT_EQ(arr[0].get_string(), "plain"sv);
+    EXPECT_EQ(arr[1].get_string(), "esc\"aped"sv);
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/lazy.hpp"
+
+#include <vector>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+constexpr auto text = R"({
+    "id": 42,
+    "name": "widget",
+    "price": 9.5,
+    "escaped": "a\"bé",
+    "tags": ["x", "y", "z"],
+    "dims": {"w": 1, "h": [2, 3], "d": {}},
+    "empty": [],
+    "ok": true,
+    "none": null
+})"sv;
+
+}
+
+TEST(lazy_test, access) {
+    auto res = json::parse_lazy(text);
+    ASSERT_TRUE(res) << res.error().what();
+    const auto doc = std::move(*res);
+    const auto root = doc.root();
+
+    EXPECT_EQ(root.type_name(), "object");
+    EXPECT_EQ(root["id"].get_int(), 42);
+    EXPECT_EQ(root["id"].type_name(), "integer");
+    EXPECT_EQ(root["name"].get_string(), "widget"sv);
+    EXPECT_EQ(root["price"].get_float(), 9.5);
+    EXPECT_EQ(root["escaped"].get_string(), "a\"b\xC3\xA9"sv);
+    EXPECT_EQ(root["tags"][2].get_string(), "z"sv);
+    EXPECT_EQ(root["dims"]["h"][1].get_int(), 3);
+    EXPECT_TRUE(root["dims"]["d"].get_object().empty());
+    EXPECT_TRUE(root["empty"].get_array().empty());
+    EXPECT_TRUE(root["ok"].get_bool());
+    EXPECT_TRUE(root["none"].is_null());
+    EXPECT_TRUE(root.has_key("dims"));
+    EXPECT_FALSE(root.has_key("missing"));
+
+    EXPECT_FALSE(root["id"].get_if_float());
+    EXPECT_FALSE(root["name"].get_if_int());
+    EXPECT_EQ(root["price"].get_if_float(), 9.5);
+
+    EXPECT_THROW(root["missing"], json::invalid_access);
+    EXPECT_THROW(root["tags"][3], json::invalid_access);
+    EXPECT_THROW(static_cast<void>(root["id"].get_string()), json::invalid_operation);
+    EXPECT_THROW(root["tags"]["x"], json::invalid_operation);
+}
+
+TEST(lazy_test, iteration) {
+    auto res = json::parse_lazy(text);
+    ASSERT_TRUE(res);
+    const auto root = res->root();
+
+    auto keys = std::vector<std::string_view>();
+    for (const auto member : root.get_object()) {
+        keys.push_back(member.first());
+    }
+    const auto expected = std::vector{"id"sv, "name"sv, "price"sv, "escaped"sv, "tags"sv, "dims"sv, "empty"sv, "ok"sv, "none"sv};
+    EXPECT_EQ(keys, expected);
+    EXPECT_EQ(root.get_object().size(), 9u);
+
+    auto tags = std::string();
+    for (const auto tag : root["tags"].get_array()) {
+        tags += tag.get_string();
+    }
+    EXPECT_EQ(tags, "xyz");
+    EXPECT_EQ(root["tags"].get_array().size(), 3u);
+}
+
+TEST(lazy_test, materialize) {
+    auto res = json::parse_lazy(text);
+    ASSERT_TRUE(res);
+    const auto root = res->root();
+    EXPECT_EQ(root["dims"].source(), R"({"w": 1, "h": [2, 3], "d": {}})"sv);
+    EXPECT_EQ(root["price"].source(), "9.5"sv);
+    EXPECT_EQ(root.to_value(), *json::parse(text));
+    EXPECT_EQ(root["dims"]["h"].to_value(), *json::parse("[2, 3]"));
+}
+
+TEST(lazy_test, errors) {
+    // Structural errors read the same as the parser's
+    for (const auto s : {""sv, "  "sv, "[1, 2"sv, "{"sv, R"({"a")"sv, R"({"a":)"sv, R"({"a" 1})"sv, R"({1: 2})"sv,
+                         "[1 2]"sv, "[1,]"sv, "1 2"sv, "[}"sv, R"({"a": 1])"sv}) {
+        const auto lazy = json::parse_lazy(s);
+        const auto full = json::parse(s);
+        ASSERT_FALSE(lazy) << s;
+        ASSERT_FALSE(full) << s;
+        EXPECT_EQ(lazy.error().what(), full.error().what()) << s;
+    }
+    auto deep = json::parse_lazy("[[[]]]", {.max_depth = 2});
+    ASSERT_FALSE(deep);
+    EXPECT_EQ(deep.error().msg, "Parser Error: Exceeded maximum nesting depth of 2");
+
+    // Scalars are only checked when they are read
+    auto res = json::parse_lazy("[1, tru, 3]");
+    ASSERT_TRUE(res);
+    EXPECT_EQ(res->root()[2].get_int(), 3);
+    EXPECT_THROW(static_cast<void>(res->root()[1].get_bool()), json::error_exception);
+}
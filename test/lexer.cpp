@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/lexer.hpp"
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+// Offsets at which the scalar lexer starts a token, for single line inputs
+auto token_offsets(std::string_view s) -> std::vector<std::uint32_t> {
+    auto offsets = std::vector<std::uint32_t>();
+    auto toks = json::lex(s);
+    EXPECT_TRUE(toks);
+    if (toks) {
+        for (const auto& tok : *toks) {
+            offsets.push_back(std::uint32_t(tok.col - 1));
+        }
+    }
+    return offsets;
+}
+
+}
+
+TEST(lexer_test, structural_index) {
+    auto escapes = std::string(R"([")");
+    for (auto i = 0; i < 100; i++) {
+        escapes += std::string(std::size_t(i % 5), '\\');
+        escapes += (i % 5) % 2 ? "\\\"" : "\"";
+        escapes += R"(, ")";
+    }
+    escapes += R"("])";
+
+    auto long_doc = std::string("[");
+    for (auto i = 0; i < 200; i++) {
+        long_doc += R"({"key": "va{l]ue", "n": -12.5e3, "b": [true, false, null]}, )";
+    }
+    long_doc += "1]";
+
+    const auto inputs = std::array{
+        ""s,
+        "   "s,
+        "5"s,
+        R"({"Aaa": 3, "Bbb": [1, 2,3], "Ccc": "x\"y"})"s,
+        R"(["\\", "\\\"", "a\\\\"])"s,
+        std::string(70, ' ') + "[1,  2]" + std::string(60, ' '),
+        escapes,
+        long_doc,
+    };
+    for (const auto& s : inputs) {
+        EXPECT_EQ(json::detail::index_structurals(s), token_offsets(s)) << s;
+    }
+}
+
+TEST(lexer_test, positions) {
+    auto toks = json::lex("[\n  1,\n\n   \"abc\"\n]");
+    ASSERT_TRUE(toks);
+    const auto expected = std::array{std::pair(1, 1), std::pair(2, 3), std::pair(2, 4), std::pair(4, 4), std::pair(5, 1)};
+    ASSERT_EQ(toks->size(), expected.size());
+    for (auto i = 0u; i < expected.size(); i++) {
+        EXPECT_EQ((*toks)[i].line, expected[i].first);
+        EXPECT_EQ((*toks)[i].col, expected[i].second);
+    }
+}
+
+TEST(lexer_test, unterminated_scalars) {
+    for (const auto s : {"truex"sv, "[nullnull]"sv, "12a"sv, "[1.5.5]"sv, "-"sv}) {
+        EXPECT_FALSE(json::lex(s)) << s;
+    }
+}
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/ordered_object.hpp"
+
+#include <sstream>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+auto keys(const json::ordered_value& val) -> std::vector<std::string> {
+    auto result = std::vector<std::string>();
+    for (const auto& [key, _] : val.get_object()) {
+        result.push_back(key);
+    }
+    return result;
+}
+
+}
+
+TEST(ordered_object_test, insertion_order) {
+    auto obj = json::ordered_object<json::ordered_value>();
+    for (auto key : {"zeta", "alpha", "mid", "beta"}) {
+        ASSERT_TRUE(obj.emplace(key, json::ordered_value(std::string(key))).second);
+    }
+    ASSERT_FALSE(obj.emplace("alpha", json::ordered_value(1)).second);
+    ASSERT_EQ(obj.at("alpha").get_string(), "alpha");
+
+    auto order = std::vector<std::string>();
+    for (const auto& member : obj) {
+        order.push_back(member.first());
+    }
+    ASSERT_EQ(order, (std::vector<std::string>{"zeta", "alpha", "mid", "beta"}));
+
+    ASSERT_TRUE(obj.erase("alpha"));
+    ASSERT_FALSE(obj.erase("alpha"));
+    ASSERT_EQ(obj.begin()[1].first(), "mid");
+    ASSERT_EQ(obj.find("alpha"), obj.end());
+
+    obj.insert_or_assign("mid", 5);
+    ASSERT_EQ(obj["mid"].get_int(), 5);
+    ASSERT_TRUE(obj["new"].holds<json::null>());
+    ASSERT_EQ(obj.size(), 4u);
+    ASSERT_THROW(obj.at("missing"), std::out_of_range);
+}
+
+// Crossing the threshold builds the index; erasing and merging keep it consistent
+TEST(ordered_object_test, index) {
+    auto obj = json::ordered_object<json::ordered_value>();
+    for (auto i = 0; i < 1000; i++) {
+        obj.emplace("key" + std::to_string(i), json::ordered_value(i));
+        for (auto j = 0; j <= i; j += 97) {
+            ASSERT_EQ(obj.at("key" + std::to_string(j)).get_int(), j);
+        }
+        ASSERT_FALSE(obj.contains("missing"));
+    }
+    for (auto i = 0; i < 1000; i += 2) {
+        ASSERT_TRUE(obj.erase("key" + std::to_string(i)));
+    }
+    ASSERT_EQ(obj.size(), 500u);
+    for (auto i = 0; i < 1000; i++) {
+        ASSERT_EQ(obj.contains("key" + std::to_string(i)), i % 2 == 1);
+    }
+    ASSERT_EQ(obj.begin()->first(), "key1");
+
+    auto other = json::ordered_object<json::ordered_value>();
+    other.emplace("key1", json::ordered_value(-1));
+    other.emplace("key0", json::ordered_value(-2));
+    obj.merge(other);
+    ASSERT_EQ(obj.size(), 501u);
+    ASSERT_EQ(obj.at("key0").get_int(), -2);
+    ASSERT_EQ(obj.at("key1").get_int(), 1);
+    ASSERT_EQ(other.size(), 1u);
+    ASSERT_EQ(other.at("key1").get_int(), -1);
+
+    auto copy = obj;
+    ASSERT_EQ(copy, obj);
+    copy.clear();
+    ASSERT_FALSE(copy.contains("key1"));
+}
+
+TEST(ordered_object_test, parse) {
+    constexpr auto s = R"({"z": 1, "a": {"y": [true, null], "b": "text"}, "m": 2.5, "z": 3})"sv;
+    auto val = json::parse<json::ordered_value>(s);
+    ASSERT_TRUE(val);
+    ASSERT_EQ(keys(*val), (std::vector<std::string>{"z", "a", "m"}));
+    ASSERT_EQ(keys((*val)["a"]), (std::vector<std::string>{"y", "b"}));
+    ASSERT_EQ((*val)["z"].get_int(), 1);
+
+    auto os = std::ostringstream();
+    os << *val;
+    ASSERT_EQ(os.str(), R"({"z":1,"a":{"y":[true,null],"b":"text"},"m":2.5})");
+
+    auto reordered = json::parse<json::ordered_value>(R"({"m": 2.5, "a": {"b": "text", "y": [true, null]}, "z": 1})");
+    ASSERT_EQ(*val, *reordered);
+}
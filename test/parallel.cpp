@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/parallel.hpp"
+#include "../include/meejson/compact.hpp"
+#include "../include/meejson/ordered_object.hpp"
+
+#include <string>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+auto records(std::size_t n) -> std::string {
+    auto s = std::string("[");
+    for (auto i = std::size_t(0); i < n; i++) {
+        s += i ? ",\n" : "\n";
+        s += R"({"id": )" + std::to_string(i) + R"(, "tags": ["a\"]", "[{"], "nested": {"x": [1.5, -2, {"y": null}]}, "ok": true})";
+    }
+    return s + "\n]";
+}
+
+// Splits everything larger than a few records
+constexpr auto small = json::parallel_options{.threads = 4, .min_split_bytes = 256};
+
+}
+
+TEST(parallel_test, array) {
+    const auto s = records(500);
+    const auto expected = json::parse(s);
+    ASSERT_TRUE(expected);
+    for (const auto threads : {1u, 2u, 4u, 7u}) {
+        for (const auto min_split_bytes : {0u, 256u, 4096u, 1u << 20}) {
+            const auto res = json::parse_parallel(s, {.threads = threads, .min_split_bytes = min_split_bytes});
+            ASSERT_TRUE(res) << res.error().what();
+            EXPECT_EQ(*res, *expected) << threads << ' ' << min_split_bytes;
+        }
+    }
+    EXPECT_EQ(*json::parse_parallel<json::compact::value>(s, small), *json::parse<json::compact::value>(s));
+    EXPECT_EQ(*json::parse_parallel<json::ordered_value>(s, small), *json::parse<json::ordered_value>(s));
+}
+
+TEST(parallel_test, nested) {
+    // An object of large arrays, and arrays of large arrays
+    const auto s = R"({"a": )" + records(100) + R"(, "b": 1, "c": [)" + records(50) + ", " + records(50) + R"(, []], "d": )" + records(3) + "}";
+    const auto expected = json::parse(s);
+    ASSERT_TRUE(expected);
+    for (const auto split_depth : {0u, 1u, 2u, 3u}) {
+        auto options = small;
+        options.split_depth = split_depth;
+        const auto res = json::parse_parallel(s, options);
+        ASSERT_TRUE(res) << res.error().what();
+        EXPECT_EQ(*res, *expected) << split_depth;
+    }
+    // Only the first of several members with the same name is kept, and the later ones aren't split
+    const auto dup = R"({"a": )" + records(100) + R"(, "k\u0065y": {"b\u0065": [)" + records(50) + R"(]}, "a": )" + records(100) + R"(, "key": 1})";
+    ASSERT_EQ(*json::parse(dup), *json::parse_parallel(dup, small));
+    for (const auto s : {"1"sv, "\"x\""sv, "[]"sv, "{}"sv, " [1, [2, 3], {}] "sv}) {
+        EXPECT_EQ(*json::parse_parallel(s, {.threads = 2, .min_split_bytes = 0}), *json::parse(s)) << s;
+    }
+}
+
+TEST(parallel_test, errors) {
+    // Errors are the first parse() would find, wherever the element holding them was parsed
+    const auto s = records(300);
+    auto bad = std::vector<std::string>{"", "  ", s.substr(0, s.size() - 1), s + "]"};
+    for (const auto at : {s.find("true", 100), s.find("1.5", s.size() / 2), s.rfind("null")}) {
+        bad.push_back(s.substr(0, at) + "nul" + s.substr(at + 4));
+    }
+    for (const auto at : {s.find("\"a", 1000), s.find('{', s.size() / 3)}) {
+        // A scalar error before a structural one comes first
+        const auto brace = s.size() - 200;
+        bad.push_back(s.substr(0, at) + "-" + s.substr(at, brace - at) + "}" + s.substr(brace));
+    }
+    for (const auto& b : bad) {
+        for (const auto threads : {2u, 4u}) {
+            auto options = small;
+            options.threads = threads;
+            const auto par = json::parse_parallel(b, options);
+            const auto full = json::parse(b);
+            ASSERT_FALSE(par) << b.size();
+            ASSERT_FALSE(full) << b.size();
+            EXPECT_EQ(par.error().what(), full.error().what()) << b.size();
+        }
+    }
+
+    const auto deep = json::parse_parallel("[[[]]]", {.parse = {.max_depth = 2}, .threads = 2, .min_split_bytes = 0});
+    ASSERT_FALSE(deep);
+    EXPECT_EQ(deep.error().msg, "Parser Error: Exceeded maximum nesting depth of 2");
+}
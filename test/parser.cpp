@@ -1,40 +1,112 @@
 #include "gtest/gtest.h"
 #include "../include/meejson/parser.hpp"
+#include "../include/meejson/document.hpp"
+#include "../include/meejson/cursor.hpp"
+#include "../include/meejson/lazy.hpp"
+#include "../include/meejson/projection.hpp"
+#include "../include/meejson/compact.hpp"
+#include "../include/meejson/ordered_object.hpp"
+
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <optional>
 
 namespace json = mee::json;
 
 using namespace std::literals;
 using namespace json::literals;
 
-TEST(parser_test, valid_input) {
-    const auto inputs = std::array{
-      std::pair("null"sv, json::value()),
-      std::pair("true"sv, json::value(true)),
-      std::pair("false"sv, json::value(false)),
-      std::pair("5"sv, json::value(5)),
-      std::pair("-2"sv, json::value(-2)),
-      std::pair("1.61803398875"sv, json::value(1.61803398875)),
-      std::pair("-1e-3"sv, json::value(-0.001)),
-      std::pair("1E3"sv, json::value(1000.0)),
-      std::pair("1.5e-2"sv, json::value(0.015)),
-      std::pair("1e+010"sv, json::value(10000000000.0)),
-      std::pair(R"("Hello World")"sv, json::value("Hello World")),
-      std::pair(R"("\" \\ \b \f \n \r \t")"sv, json::value("\" \\ \b \f \n \r \t")),
-      std::pair(R"("\u3053\u3093\u306B\u3061\u306F\u4E16\u754C")"sv, json::value("こんにちは世界")),
-      std::pair(R"("こんにちは世界")"sv, json::value("こんにちは世界")),
-      std::pair(R"([])"sv, json::value(json::array())),
-      std::pair(R"([1, null, false, "A", 3.1415])"sv, json::value{json::value(1), json::value(), json::value(false), json::value("A"), json::value(3.1415)}),
-      std::pair(R"({})"sv, json::value(json::object())),
-      std::pair(R""({"Aaa": 3, "Bbb": 2, "Ccc": 1})""sv, json::value{{"Aaa", 3_value}, {"Bbb", 2_value}, {"Ccc", 1_value}}),
-      std::pair("[[[[[[[[[[[[[[[3]]]]]]]]]]]]]]]"sv, json::value{{{{{{{{{{{{{{{3_value}}}}}}}}}}}}}}}),
-    };
+namespace {
+
+std::size_t allocations = 0;
+
+}
+
+// Kept out of line so GCC doesn't pair the malloc() and free() inside them with new and delete
+// expressions and warn about a mismatch
+[[gnu::noinline]] auto operator new(std::size_t n) -> void* {
+    allocations++;
+    if (auto p = std::malloc(n)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+const auto valid_inputs = std::array{
+    std::pair("null"sv, json::value()),
+    std::pair("true"sv, json::value(true)),
+    std::pair("false"sv, json::value(false)),
+    std::pair("5"sv, json::value(5)),
+    std::pair("-2"sv, json::value(-2)),
+    std::pair("1.61803398875"sv, json::value(1.61803398875)),
+    std::pair("-1e-3"sv, json::value(-0.001)),
+    std::pair("1E3"sv, json::value(1000.0)),
+    std::pair("1.5e-2"sv, json::value(0.015)),
+    std::pair("1e+010"sv, json::value(10000000000.0)),
+    std::pair("9223372036854775807"sv, json::value(std::numeric_limits<std::int64_t>::max())),
+    std::pair("-9223372036854775808"sv, json::value(std::numeric_limits<std::int64_t>::min())),
+    std::pair("9223372036854775808"sv, json::value(9223372036854775808.0)),
+    std::pair("123456789012345678901234567890"sv, json::value(123456789012345678901234567890.0)),
+    std::pair("0.1"sv, json::value(0.1)),
+    std::pair("-0.0"sv, json::value(-0.0)),
+    std::pair("1.7976931348623157e308"sv, json::value(1.7976931348623157e308)),
+    std::pair("2.2250738585072014e-308"sv, json::value(2.2250738585072014e-308)),
+    std::pair("4.9e-324"sv, json::value(4.9e-324)),
+    std::pair("1e-400"sv, json::value(0.0)),
+    std::pair("3.14159265358979323846264338327950288"sv, json::value(3.14159265358979323846264338327950288)),
+    std::pair(R"("Hello World")"sv, json::value("Hello World")),
+    std::pair(R"("\" \\ \b \f \n \r \t")"sv, json::value("\" \\ \b \f \n \r \t")),
+    std::pair(R"("\u3053\u3093\u306B\u3061\u306F\u4E16\u754C")"sv, json::value("こんにちは世界")),
+    std::pair(R"("こんにちは世界")"sv, json::value("こんにちは世界")),
+    std::pair(R"("\uD83D\uDE00 \u00e9 \/")"sv, json::value("😀 é /")),
+    std::pair(R"("https://example.com/a/very/long/path/that/spans/several/simd/blocks?with=query&and=more")"sv,
+              json::value("https://example.com/a/very/long/path/that/spans/several/simd/blocks?with=query&and=more")),
+    std::pair(R"([])"sv, json::value(json::array())),
+    std::pair(R"([1, null, false, "A", 3.1415])"sv, json::value{json::value(1), json::value(), json::value(false), json::value("A"), json::value(3.1415)}),
+    std::pair(R"({})"sv, json::value(json::object())),
+    std::pair(R""({"Aaa": 3, "Bbb": 2, "Ccc": 1})""sv, json::value{{"Aaa", 3_value}, {"Bbb", 2_value}, {"Ccc", 1_value}}),
+    std::pair("[[[[[[[[[[[[[[[3]]]]]]]]]]]]]]]"sv, json::value{{{{{{{{{{{{{{{3_value}}}}}}}}}}}}}}}),
+};
 
-    for (const auto& [s, res] : inputs) {
+}
+
+TEST(parser_test, valid_input) {
+    for (const auto& [s, res] : valid_inputs) {
         auto val = json::parse(s);
         EXPECT_TRUE(val);
         if (val) {
             EXPECT_EQ(*val, res);
         }
+        auto recursive = json::detail::parse_recursive(s);
+        EXPECT_TRUE(recursive);
+        if (recursive) {
+            EXPECT_EQ(*recursive, res);
+        }
+    }
+}
+
+TEST(parser_test, token_input) {
+    for (const auto& [s, res] : valid_inputs) {
+        auto toks = json::lex(s);
+        EXPECT_TRUE(toks);
+        if (toks) {
+            auto val = json::parse(*toks);
+            EXPECT_TRUE(val);
+            if (val) {
+                EXPECT_EQ(*val, res);
+            }
+        }
     }
 }
 
@@ -45,10 +117,21 @@ TEST(parser_test, invalid_input) {
         "3."sv,
         "."sv,
         "010"sv,
+        "-"sv,
+        "-.5"sv,
+        "1.e5"sv,
+        "1e"sv,
+        "1e400"sv,
+        "-1e400"sv,
         "aaaaaaaaaaa"sv,
         R"(")"sv,
         "fals"sv,
         R"("\ugggg")"sv,
+        R"("\uD83D")"sv,
+        R"("\uDE00\uD83D")"sv,
+        R"("\uD83D\u0041")"sv,
+        "\"a\tb\""sv,
+        R"("\x")"sv,
         "["sv,
         "]"sv,
         "{"sv,
@@ -58,6 +141,173 @@ TEST(parser_test, invalid_input) {
         "{1: 2, true: false, {}: []}"sv
     };
     for (const auto s : inputs) {
-        EXPECT_FALSE(json::parse(s));
+        auto val = json::parse(s);
+        auto recursive = json::detail::parse_recursive(s);
+        EXPECT_FALSE(val);
+        EXPECT_FALSE(recursive);
+        if (!val && !recursive) {
+            EXPECT_EQ(val.error().what(), recursive.error().what());
+        }
+    }
+}
+
+TEST(parser_test, max_depth) {
+    auto nested = [](std::size_t depth) {
+        return std::string(depth, '[') + std::string(depth, ']');
+    };
+    auto nested_objects = [](std::size_t depth) {
+        auto s = std::string();
+        for (auto i = 0u; i < depth; i++) {
+            s += R"({"a": )";
+        }
+        return s + "0" + std::string(depth, '}');
+    };
+    const auto options = json::parse_options{.max_depth = 8};
+    EXPECT_TRUE(json::parse(nested(8), options));
+    EXPECT_TRUE(json::parse(nested_objects(8), options));
+    EXPECT_TRUE(json::detail::parse_recursive(nested(8), options));
+    EXPECT_TRUE(json::parse(*json::lex(nested(8)), options));
+    EXPECT_FALSE(json::parse(nested(9), options));
+    EXPECT_FALSE(json::parse(nested_objects(9), options));
+    EXPECT_FALSE(json::detail::parse_recursive(nested(9), options));
+    EXPECT_FALSE(json::parse(*json::lex(nested(9)), options));
+
+    // Hostile nesting fails cleanly rather than overflowing the stack
+    auto res = json::parse(nested(1'000'000));
+    EXPECT_FALSE(res);
+    if (!res) {
+        EXPECT_EQ(res.error().msg, "Parser Error: Exceeded maximum nesting depth of 1024");
+    }
+    EXPECT_FALSE(json::detail::parse_recursive(nested(1'000'000)));
+    EXPECT_FALSE(json::parse(*json::lex(nested(1'000'000))));
+
+    // The iterative parser is only limited by memory
+    auto deep = json::parse(nested(20'000), json::parse_options{.max_depth = 20'000});
+    EXPECT_TRUE(deep);
+}
+
+TEST(parser_test, allocations_linear_in_size) {
+    // Every level holds a string and a nested array, so copying finished aggregates on the way back
+    // up would make the allocation count grow with depth * size rather than size
+    auto nested = [](std::size_t depth) {
+        auto s = std::string();
+        for (auto i = 0u; i < depth; i++) {
+            s += R"(["a string longer than the small string buffer", )";
+        }
+        s += '0';
+        s += std::string(depth, ']');
+        return s;
+    };
+    auto count = [](const std::string& s) {
+        auto before = allocations;
+        auto val = json::parse(s);
+        auto after = allocations;
+        EXPECT_TRUE(val);
+        return after - before;
+    };
+    const auto small = count(nested(64));
+    const auto large = count(nested(256));
+    EXPECT_LE(large, small * 4 + 16);
+}
+
+// Deeply nested values are torn down without recursing once per level or allocating
+TEST(parser_test, deep_destruction) {
+    constexpr auto depth = std::size_t(100'000);
+    auto s = std::string();
+    for (auto i = 0u; i < depth; i++) {
+        s += i % 2 ? R"({"a": [], "b": )" : "[0, ";
+    }
+    s += "null";
+    for (auto i = depth; i-- > 0;) {
+        s += i % 2 ? '}' : ']';
     }
-}
\ No newline at end of file
+    const auto options = json::parse_options{.max_depth = depth + 1};
+    auto destroy = [&s, &options]<class Value>(std::type_identity<Value>) {
+        auto val = std::optional(json::parse<Value>(s, options));
+        ASSERT_TRUE(*val);
+        auto before = allocations;
+        val.reset();
+        EXPECT_EQ(allocations - before, 0u);
+    };
+    destroy(std::type_identity<json::value>());
+    destroy(std::type_identity<json::ordered_value>());
+    destroy(std::type_identity<json::compact::value>());
+}
+
+TEST(parser_test, document_allocations) {
+    auto s = std::string("[");
+    for (auto i = 0; i < 10'000; i++) {
+        s += R"({"key": "a string longer than the small string buffer", "values": [1, 2.5, true, null]},)";
+    }
+    s += "{}]";
+    auto before = allocations;
+    auto doc = json::parse_document(s);
+    EXPECT_TRUE(doc);
+    // The structural index, the parser's stack and a handful of arena blocks
+    EXPECT_LE(allocations - before, 32u);
+}
+
+// Looking keys up by view or precomputed hash never builds a key
+TEST(parser_test, lookup_allocations) {
+    constexpr auto key = "a key longer than the small string buffer"sv;
+    const auto val = json::parse(R"({"a key longer than the small string buffer": [1, {"nested key that is long too": null}]})");
+    ASSERT_TRUE(val);
+    const auto nested = json::hashed_key("nested key that is long too");
+    auto before = allocations;
+    EXPECT_TRUE(val->has_key(key));
+    EXPECT_TRUE((*val)[key][1].has_key(nested));
+    EXPECT_TRUE((*val)[key][1][nested].holds<json::null>());
+    EXPECT_NE(val->get_object().find(key), val->get_object().end());
+    EXPECT_FALSE(val->get_object().contains(json::hashed_key("missing")));
+    EXPECT_EQ(allocations - before, 0u);
+}
+
+// Reading through a cursor allocates nothing, however long the keys and strings
+TEST(parser_test, cursor_allocations) {
+    const auto s = R"({"a key longer than the small string buffer": [1, {"nested key that is long too": "a string value that is long too"}], "b": [true, 2.5, null]})"sv;
+    auto before = allocations;
+    auto c = json::cursor(s);
+    auto sum = std::int64_t(0);
+    for (const auto elem : c["a key longer than the small string buffer"].get_array()) {
+        if (auto i = elem.get_if_int()) {
+            sum += *i;
+        } else {
+            EXPECT_EQ(elem["nested key that is long too"].get_string().size(), 31u);
+        }
+    }
+    EXPECT_EQ(sum, 1);
+    EXPECT_TRUE(c["b"][0].get_bool());
+    EXPECT_EQ(c["b"][1].get_float(), 2.5);
+    EXPECT_TRUE(c["b"][2].is_null());
+    EXPECT_EQ(allocations - before, 0u);
+}
+
+// Looking keys up in a lazy document decodes nothing it keeps, and each escaped string is decoded once
+TEST(parser_test, lazy_allocations) {
+    const auto s = R"({"k\u00e9y that is longer than the small string buffer": 1, "b": "an escaped\tstring longer than the buffer"})"s;
+    auto doc = json::parse_lazy(s);
+    ASSERT_TRUE(doc);
+    const auto first = doc->root()["b"].get_string();
+    auto before = allocations;
+    for (auto i = 0; i < 1000; i++) {
+        EXPECT_EQ(doc->root()["b"].get_string().data(), first.data());
+        EXPECT_TRUE(doc->root().has_key("k\xC3\xA9y that is longer than the small string buffer"));
+    }
+    EXPECT_EQ(allocations - before, 0u);
+}
+
+// Values left out of a projection are checked without building anything, escapes included
+TEST(parser_test, projection_allocations) {
+    auto s = std::string(R"({"id": 7, "values": [)");
+    for (auto i = 0; i < 10'000; i++) {
+        s += R"({"key": "a string longer than the small \"string\" buffer \u00e9", "n": [1, 2.5e300, true, null]},)";
+    }
+    s += "{}]}";
+    const auto fields = json::projection{"/id"};
+    auto before = allocations;
+    const auto val = json::parse(s, {.fields = &fields});
+    ASSERT_TRUE(val);
+    EXPECT_EQ(*val, *json::parse(R"({"id": 7})"));
+    // The structural index, the parser's and projection's stacks and the one member kept
+    EXPECT_LE(allocations - before, 48u);
+}
@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/projection.hpp"
+#include "../include/meejson/document.hpp"
+#include "../include/meejson/ordered_object.hpp"
+#include "../include/meejson/stream.hpp"
+
+#include <string>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+using json::operator""_json;
+
+namespace {
+
+constexpr auto event = R"({
+    "id": 42,
+    "kind": "click",
+    "user": {"name": "ann", "email": "aé@example.com", "roles": ["admin", "dev"]},
+    "items": [{"sku": "a", "qty": 1}, {"sku": "b", "qty": 2.5e3}, {"sku": "c\n", "qty": -0}],
+    "meta": {"trace": [1, [2, [3]], {"x": null}], "ok": true},
+    "a/b": 1,
+    "m~n": 2
+})"sv;
+
+}
+
+TEST(projection_test, fields) {
+    const auto fields = json::projection{"/id", "/user/name", "/user/roles", "/missing/x"};
+    const auto res = json::parse(event, {.fields = &fields});
+    ASSERT_TRUE(res) << res.error().what();
+    EXPECT_EQ(*res, R"({"id": 42, "user": {"name": "ann", "roles": ["admin", "dev"]}})"_json);
+
+    // A path kept whole swallows any longer path through it
+    const auto whole = json::projection{"/meta/trace/1", "/meta", "/items/1/sku", "/items/2"};
+    EXPECT_EQ(*json::parse(event, {.fields = &whole}),
+              R"({"items": [{"sku": "b"}, {"sku": "c\n", "qty": 0}], "meta": {"trace": [1, [2, [3]], {"x": null}], "ok": true}})"_json);
+
+    // Escaped names, and paths running into scalars
+    const auto escaped = json::projection{"/a~1b", "/m~0n", "/id/x", "/kind/0"};
+    EXPECT_EQ(*json::parse(event, {.fields = &escaped}), R"({"a/b": 1, "m~n": 2})"_json);
+
+    const auto everything = json::projection{""};
+    EXPECT_EQ(*json::parse(event, {.fields = &everything}), *json::parse(event));
+    const auto nothing = json::projection{};
+    EXPECT_EQ(*json::parse(event, {.fields = &nothing}), json::value(json::object()));
+    EXPECT_TRUE(json::parse("[1, 2]", {.fields = &nothing})->get_array().empty());
+    EXPECT_TRUE(json::parse("5", {.fields = &nothing})->holds<json::null>());
+}
+
+TEST(projection_test, flavours) {
+    const auto fields = json::projection{"/user/email", "/items/0"};
+    const auto expected = R"({"user": {"email": "aé@example.com"}, "items": [{"sku": "a", "qty": 1}]})"sv;
+    EXPECT_EQ(*json::parse<json::ordered_value>(event, {.fields = &fields}), *json::parse<json::ordered_value>(expected));
+    EXPECT_EQ(json::parse_document(event, {.fields = &fields})->root(), json::parse_document(expected)->root());
+    const auto view = json::parse_view_document(event, {.fields = &fields});
+    ASSERT_TRUE(view);
+    EXPECT_EQ(view->root()["user"]["email"].get_string(), "a\xC3\xA9@example.com"sv);
+
+    auto s = std::string();
+    for (auto i = 0; i < 100; i++) {
+        s += R"({"id": )" + std::to_string(i) + R"(, "skip": {"deep": [1, "two", {"three": 3}]}, "name": "n)" + std::to_string(i) + "\"}\n";
+    }
+    const auto ids = json::projection{"/id"};
+    for (const auto threads : {1u, 3u}) {
+        const auto results = json::parse_many(s, {.parse = {.fields = &ids}, .threads = threads, .batch_size = 256});
+        ASSERT_EQ(results.size(), 100u);
+        for (auto i = 0; i < 100; i++) {
+            EXPECT_EQ(*results[std::size_t(i)], *json::parse(R"({"id": )" + std::to_string(i) + "}"));
+        }
+    }
+}
+
+TEST(projection_test, errors) {
+    // Skipped values are still checked, and fail just as they do in a full parse
+    const auto fields = json::projection{"/keep"};
+    for (const auto s : {R"({"keep": 1, "skip": [1, 2})"sv, R"({"keep": 1, "skip": tru})"sv, R"({"keep": 1, "skip": 01})"sv,
+                         R"({"keep": 1, "skip": -})"sv, R"({"keep": 1, "skip": 1.e5})"sv, R"({"keep": 1, "skip": 1x})"sv,
+                         R"({"keep": 1, "skip": "a\qb"})"sv, R"({"keep": 1, "skip": "\ud800"})"sv, R"({"keep": 1, "skip": "ab)"sv,
+                         "{\"keep\": 1, \"skip\": \"a\nb\"}"sv, R"({"keep": 1, "skip": {"a" 1}})"sv, R"({"keep": 1, "skip": {1: 2}})"sv,
+                         R"({"keep": 1, "skip": [1,]})"sv, R"({"keep": 1, "skip": [}})"sv, R"({"keep": 1, "skip": [1 2]})"sv,
+                         R"({"keep": 1, "skip": ])"sv, R"({"keep": 1, "skip": [[[]]]})"sv, R"({"keep": 1, "skip": 1} 2)"sv,
+                         R"({"keep": 1, "skip": 1e400})"sv, R"({"keep": 1, "skip": -0.0012e312})"sv, R"({"keep": 1, "skip": 1.8e308})"sv,
+                         R"({"keep": 1, "skip": 1e99999999999999999999})"sv, ""sv}) {
+        const auto projected = json::parse(s, {.max_depth = 3, .fields = &fields});
+        const auto full = json::parse(s, {.max_depth = 3});
+        ASSERT_FALSE(projected) << s;
+        ASSERT_FALSE(full) << s;
+        EXPECT_EQ(projected.error().what(), full.error().what()) << s;
+    }
+
+    // Only numbers past the largest double are out of range
+    for (const auto s : {R"({"keep": 1, "skip": 1.7e308})"sv, R"({"keep": 1, "skip": 0.00e999})"sv, R"({"keep": 1, "skip": 1e-400})"sv,
+                         R"({"keep": 1, "skip": 0.0017e311})"sv}) {
+        EXPECT_TRUE(json::parse(s, {.fields = &fields})) << s;
+        EXPECT_TRUE(json::parse(s)) << s;
+    }
+
+    EXPECT_THROW(json::projection({"id"}), json::error_exception);
+    EXPECT_THROW(json::projection({"/a~2"}), json::error_exception);
+    EXPECT_THROW(json::projection({"/a~"}), json::error_exception);
+    EXPECT_EQ(*json::detail::split_pointer("/a~1b/~0/"), (std::vector<std::string>{"a/b", "~", ""}));
+    EXPECT_TRUE(json::detail::split_pointer("")->empty());
+}
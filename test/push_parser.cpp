@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/push_parser.hpp"
+
+#include <random>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+// Feeds `s` in pieces of at most `max_piece` bytes
+auto parse_pieces(std::string_view s, std::size_t max_piece, std::mt19937& gen) -> json::result<json::value> {
+    auto parser = json::push_parser();
+    auto dist = std::uniform_int_distribution<std::size_t>(1, max_piece);
+    while (!s.empty()) {
+        const auto n = std::min(dist(gen), s.size());
+        if (auto err = parser.feed(s.substr(0, n))) {
+            return std::move(*err);
+        }
+        s.remove_prefix(n);
+    }
+    return parser.finish();
+}
+
+}
+
+TEST(push_parser_test, pieces) {
+    constexpr auto s = R"({"a": [1, -2.5e3, 3.0, true, false, null, "x\ty\"z\\", {"nested": [[], {}]}],
+                          "bé": "é😀", "c": 1e-7, "long": "abcdefghijklmnopqrstuvwxyz"})"sv;
+    const auto expected = *json::parse(s);
+    auto gen = std::mt19937(42);
+    for (auto max_piece : {1, 2, 3, 7, 64}) {
+        for (auto i = 0; i < 20; i++) {
+            auto val = parse_pieces(s, std::size_t(max_piece), gen);
+            ASSERT_TRUE(val) << val.error().what();
+            EXPECT_EQ(*val, expected);
+        }
+    }
+}
+
+TEST(push_parser_test, scalars) {
+    auto gen = std::mt19937(42);
+    for (const auto s : {"12345"sv, "-0.5"sv, "true"sv, "null"sv, R"("aAb")"sv, " 7 "sv}) {
+        auto val = parse_pieces(s, 1, gen);
+        ASSERT_TRUE(val) << s;
+        EXPECT_EQ(*val, *json::parse(s)) << s;
+    }
+
+    // A top level number may go on until the input ends
+    auto parser = json::push_parser();
+    EXPECT_FALSE(parser.feed("12"sv));
+    EXPECT_FALSE(parser.done());
+    EXPECT_FALSE(parser.feed("34"sv));
+    auto val = parser.finish();
+    ASSERT_TRUE(val);
+    EXPECT_EQ(val->get_int(), 1234);
+}
+
+TEST(push_parser_test, done) {
+    auto parser = json::push_parser();
+    EXPECT_FALSE(parser.feed(R"({"a": [1, 2)"sv));
+    EXPECT_FALSE(parser.done());
+    EXPECT_FALSE(parser.feed("]}"sv));
+    EXPECT_TRUE(parser.done());
+    EXPECT_FALSE(parser.feed("  \n"sv));
+    auto val = parser.finish();
+    ASSERT_TRUE(val);
+    EXPECT_EQ(val->get_object().at("a").get_array().size(), 2);
+}
+
+TEST(push_parser_test, errors) {
+    // Errors read the same as the contiguous parser's, wherever the input is split
+    auto gen = std::mt19937(42);
+    for (const auto s : {""sv, "  "sv, "[1, 2"sv, "{"sv, R"({"a")"sv, R"({"a":)"sv, R"({"a" 1})"sv, R"({1: 2})"sv,
+                         "[1 2]"sv, "[1,]"sv, "1 2"sv, R"(["abc)"sv, "[1.]"sv, "\n\n  [\"a\nb\"]"sv,
+                         R"(["\x"])"sv, R"("\u12")"sv}) {
+        const auto expected = json::parse(s);
+        ASSERT_FALSE(expected) << s;
+        for (auto max_piece : {1, 3, 100}) {
+            auto val = parse_pieces(s, std::size_t(max_piece), gen);
+            ASSERT_FALSE(val) << s;
+            EXPECT_EQ(val.error().what(), expected.error().what()) << s;
+        }
+    }
+
+    // The contiguous lexer quotes a fixed number of bytes of an unknown literal, which can run past
+    // the token; cut off at a piece boundary only the token itself is there to quote
+    for (const auto s : {"[tru]"sv, "[1,\n 2,\n nul]"sv}) {
+        const auto expected = json::parse(s);
+        for (auto max_piece : {1, 3, 100}) {
+            auto val = parse_pieces(s, std::size_t(max_piece), gen);
+            ASSERT_FALSE(val) << s;
+            EXPECT_EQ(val.error().line, expected.error().line) << s;
+            EXPECT_EQ(val.error().col, expected.error().col) << s;
+            EXPECT_TRUE(val.error().msg.starts_with("Lexer Error: Unknown literal")) << s;
+        }
+    }
+
+    auto parser = json::push_parser({.max_depth = 2});
+    const auto err = parser.feed("[[["sv);
+    ASSERT_TRUE(err);
+    EXPECT_EQ(err->msg, "Parser Error: Exceeded maximum nesting depth of 2");
+    // Errors stick
+    EXPECT_TRUE(parser.feed("]]]"sv));
+    EXPECT_FALSE(parser.finish());
+}
@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/query.hpp"
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/compact.hpp"
+#include "../include/meejson/ordered_object.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+using json::operator""_json;
+
+namespace {
+
+const auto store = R"({
+    "store": {
+        "book": [
+            {"category": "reference", "author": "Nigel Rees", "title": "Sayings of the Century", "price": 8.95},
+            {"category": "fiction", "author": "Evelyn Waugh", "title": "Sword of Honour", "price": 12.99},
+            {"category": "fiction", "author": "Herman Melville", "title": "Moby Dick", "isbn": "0-553-21311-3", "price": 8.99},
+            {"category": "fiction", "author": "J. R. R. Tolkien", "title": "The Lord of the Rings", "isbn": "0-395-19395-8", "price": 22}
+        ],
+        "bicycle": {"color": "red", "price": 399}
+    },
+    "a/b": {"m~n": 1, "": 2},
+    "0": "zero"
+})"_json;
+
+// The matches as the text of an array
+auto run(std::string_view q, const json::value& v = store) -> std::string {
+    auto compiled = json::compile_query(q);
+    EXPECT_TRUE(compiled) << q << ' ' << compiled.error().what();
+    auto s = std::string("[");
+    for (const auto match : compiled->find(v)) {
+        s += s.size() == 1 ? "" : ",";
+        s += json::dump(*match);
+    }
+    return s + ']';
+}
+
+// The matches, sorted, for queries running through unordered objects
+auto run_sorted(std::string_view q) -> std::vector<std::string> {
+    auto matches = std::vector<std::string>();
+    for (const auto match : json::compile_query(q)->find(store)) {
+        matches.push_back(json::dump(*match));
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+}
+
+TEST(query_test, pointer) {
+    EXPECT_EQ(run("/store/book/1/author"), R"(["Evelyn Waugh"])");
+    EXPECT_EQ(run("/store/bicycle/price"), "[399]");
+    EXPECT_EQ(run("/a~1b/m~0n"), "[1]");
+    EXPECT_EQ(run("/a~1b/"), "[2]");
+    EXPECT_EQ(run("/0"), R"(["zero"])");
+    EXPECT_EQ(json::compile_query("")->find(store), std::vector{&store});
+    EXPECT_EQ(run("/store/book/4"), "[]");
+    EXPECT_EQ(run("/store/book/01"), "[]");
+    EXPECT_EQ(run("/store/book/-"), "[]");
+    EXPECT_EQ(run("/store/missing/x"), "[]");
+    EXPECT_EQ(run("/store/bicycle/color/0"), "[]");
+
+    const auto q = json::compile_query("/store/book/3/price");
+    ASSERT_TRUE(q);
+    EXPECT_EQ(*q->find_first(store), 22);
+    EXPECT_FALSE(json::compile_query("/nope")->find_first(store));
+    EXPECT_EQ(*q->find_first(*json::parse<json::compact::value>(json::dump(store))), 22);
+    EXPECT_EQ(*q->find_first(*json::parse<json::ordered_value>(json::dump(store))), 22);
+}
+
+TEST(query_test, path) {
+    EXPECT_EQ(run("$.store.book[0].title"), R"(["Sayings of the Century"])");
+    EXPECT_EQ(run("$['store'][\"book\"][-1]['title']"), R"(["The Lord of the Rings"])");
+    EXPECT_EQ(run("$.store.book[*].author"), R"(["Nigel Rees","Evelyn Waugh","Herman Melville","J. R. R. Tolkien"])");
+    EXPECT_EQ(run("$.store.book[0, 2].price"), "[8.95,8.99]");
+    EXPECT_EQ(run_sorted("$..price"), (std::vector<std::string>{"12.99", "22", "399", "8.95", "8.99"}));
+    EXPECT_EQ(run_sorted("$.store.*.color"), std::vector<std::string>{R"("red")"});
+    EXPECT_EQ(run("$..book[?@.isbn].title"), R"(["Moby Dick","The Lord of the Rings"])");
+    EXPECT_EQ(run("$..book[?(@.price < 10)].title"), R"(["Sayings of the Century","Moby Dick"])");
+    EXPECT_EQ(run("$.store.book[?(@.price >= 12.99 && @.category == 'fiction')].title"), R"(["Sword of Honour","The Lord of the Rings"])");
+    EXPECT_EQ(run("$.store.book[?(@.author == \"Nigel Rees\" || @.price == 22)].price"), "[8.95,22]");
+    EXPECT_EQ(run("$.store.book[?(@.isbn != '0-553-21311-3')].price"), "[8.95,12.99,22]");
+    EXPECT_EQ(run("$[?@ > 2]", "[1, 5, 2.5, \"x\", true, null, [3]]"_json), "[5,2.5]");
+    EXPECT_EQ(run("$[?@ == null]", "[1, null, {}]"_json), "[null]");
+    EXPECT_EQ(run("$[?@ < 'b']", R"(["a", "c", 1])"_json), R"(["a"])");
+    EXPECT_EQ(run("$[?@[0] == true]", "[[true], [false], [1]]"_json), "[[true]]");
+    EXPECT_EQ(run("$['a/b']['m~n']"), "[1]");
+    EXPECT_EQ(run("$['it\\'s']", R"({"it's": 1})"_json), "[1]");
+    EXPECT_EQ(run("$[\"\\u00e9\"]", R"({"é": 1})"_json), "[1]");
+    EXPECT_EQ(json::compile_query("$")->find(store), std::vector{&store});
+
+    // Each value is matched once, however many ways the query reaches it
+    EXPECT_EQ(run("$..[0]", "[[1], [[2]]]"_json), "[[1],1,[2],2]");
+    EXPECT_EQ(run("$[0, 0, -2]", "[1, 2]"_json), "[1]");
+}
+
+TEST(query_test, set) {
+    auto queries = std::vector<json::query>();
+    for (const auto q : {"/store/bicycle/color", "$.store.book[*].price", "$..isbn", "/missing", "/store/book/0/author", "$.store.book[?@.price > 20]"}) {
+        queries.push_back(*json::compile_query(q));
+    }
+    const auto set = json::query_set(std::move(queries));
+    const auto results = set.evaluate(store);
+    ASSERT_EQ(results.size(), 6u);
+    ASSERT_EQ(results[0].size(), 1u);
+    EXPECT_EQ(*results[0][0], "red"sv);
+    EXPECT_EQ(results[1].size(), 4u);
+    EXPECT_EQ(results[2].size(), 2u);
+    EXPECT_TRUE(results[3].empty());
+    ASSERT_EQ(results[4].size(), 1u);
+    EXPECT_EQ(*results[4][0], "Nigel Rees"sv);
+    ASSERT_EQ(results[5].size(), 1u);
+    EXPECT_EQ((*results[5][0])["price"], 22);
+
+    auto count = std::size_t(0);
+    set.for_each(store, [&count](std::size_t, const json::value&) { count++; });
+    EXPECT_EQ(count, 9u);
+}
+
+TEST(query_test, errors) {
+    for (const auto q : {"nope"sv, "/a~2"sv, "$."sv, "$x"sv, "$.1a"sv, "$["sv, "$[1"sv, "$['a"sv, "$['\\q']"sv, "$[?@.a ==]"sv,
+                         "$[?(@.a == 1]"sv, "$[?a]"sv, "$[?@.a == nul]"sv, "$[?@.a = 1]"sv}) {
+        EXPECT_FALSE(json::compile_query(q)) << q;
+    }
+    const auto err = json::compile_query("$.a[b]");
+    ASSERT_FALSE(err);
+    EXPECT_EQ(err.error().msg, "Query Error: Expected a selector");
+    EXPECT_EQ(err.error().col, 5);
+}
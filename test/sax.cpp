@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/sax.hpp"
+
+#include <string>
+#include <vector>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+// Writes every event on a line of its own
+struct recorder {
+    std::vector<std::string> events;
+    std::size_t stop_after = std::size_t(-1);
+
+    auto record(std::string e) -> bool {
+        events.push_back(std::move(e));
+        return events.size() < stop_after;
+    }
+
+    auto on_null() -> bool { return record("null"); }
+    auto on_bool(bool b) -> bool { return record(b ? "true" : "false"); }
+    auto on_int(std::int64_t i) -> bool { return record("int " + std::to_string(i)); }
+    auto on_double(double d) -> bool { return record("double " + std::to_string(d)); }
+    auto on_string(std::string_view s) -> bool { return record("string " + std::string(s)); }
+    auto on_key(std::string_view s) -> bool { return record("key " + std::string(s)); }
+    auto start_object() -> bool { return record("{"); }
+    auto end_object() -> bool { return record("}"); }
+    auto start_array() -> bool { return record("["); }
+    auto end_array() -> bool { return record("]"); }
+};
+
+static_assert(json::sax_handler<recorder>);
+static_assert(!json::sax_handler<int>);
+
+}
+
+TEST(sax_test, events) {
+    auto r = recorder();
+    const auto err = json::parse_sax(R"({"a": [1, 2.5, "x\ty", true, false, null], "bé": {}, "c": []})", r);
+    ASSERT_FALSE(err);
+    const auto expected = std::vector<std::string>{
+        "{", "key a", "[", "int 1", "double 2.500000", "string x\ty", "true", "false", "null", "]",
+        "key b\xC3\xA9", "{", "}", "key c", "[", "]", "}"
+    };
+    EXPECT_EQ(r.events, expected);
+
+    r.events.clear();
+    ASSERT_FALSE(json::parse_sax(" \"top\" ", r));
+    EXPECT_EQ(r.events, std::vector<std::string>{"string top"});
+}
+
+TEST(sax_test, errors) {
+    // Syntax errors read the same as the DOM parser's
+    for (const auto s : {""sv, "[1, 2"sv, R"({"a" 1})"sv, R"({1: 2})"sv, "[1 2]"sv, "[1,]"sv, "1 2"sv, R"(["abc)"sv}) {
+        auto r = recorder();
+        const auto err = json::parse_sax(s, r);
+        const auto dom = json::parse(s);
+        ASSERT_TRUE(err) << s;
+        ASSERT_FALSE(dom) << s;
+        EXPECT_EQ(err->what(), dom.error().what()) << s;
+    }
+
+    auto r = recorder();
+    const auto err = json::parse_sax("[[[1]]]", r, {.max_depth = 2});
+    ASSERT_TRUE(err);
+    EXPECT_EQ(err->msg, "Parser Error: Exceeded maximum nesting depth of 2");
+}
+
+TEST(sax_test, stop) {
+    auto r = recorder();
+    r.stop_after = 3;
+    const auto err = json::parse_sax("[1, 2, 3, 4]", r);
+    ASSERT_TRUE(err);
+    EXPECT_EQ(err->msg, "Parser Error: Stopped by handler");
+    EXPECT_EQ(r.events, (std::vector<std::string>{"[", "int 1", "int 2"}));
+}
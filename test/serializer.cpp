@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/parser.hpp"
+#include "../include/meejson/compact.hpp"
+#include "../include/meejson/ordered_object.hpp"
+
+#include <bit>
+#include <cmath>
+#include <random>
+#include <sstream>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+using namespace json::literals;
+
+TEST(serializer_test, scalars) {
+    EXPECT_EQ(json::dump(json::value()), "null");
+    EXPECT_EQ(json::dump(json::value(true)), "true");
+    EXPECT_EQ(json::dump(json::value(false)), "false");
+    EXPECT_EQ(json::dump(json::value(-42)), "-42");
+    EXPECT_EQ(json::dump(json::value(std::numeric_limits<std::int64_t>::min())), "-9223372036854775808");
+    EXPECT_EQ(json::dump(json::value(2.5)), "2.5");
+    EXPECT_EQ(json::dump(json::value(2.0)), "2.0");
+    EXPECT_EQ(json::dump(json::value(1e300)), "1e+300");
+    EXPECT_EQ(json::dump(json::value(0.1)), "0.1");
+    EXPECT_EQ(json::dump(json::value(-0.0)), "-0.0");
+    EXPECT_EQ(json::dump(json::value(123456789.0)), "123456789.0");
+    EXPECT_EQ(json::dump(json::value(NAN)), "null");
+    EXPECT_EQ(json::dump(json::value(-INFINITY)), "null");
+}
+
+TEST(serializer_test, escapes) {
+    EXPECT_EQ(json::dump("plain"_value), R"("plain")");
+    EXPECT_EQ(json::dump(json::value("quote \" backslash \\ slash /"s)), R"("quote \" backslash \\ slash /")");
+    EXPECT_EQ(json::dump(json::value("\b\f\n\r\t"s)), R"("\b\f\n\r\t")");
+    EXPECT_EQ(json::dump(json::value("\x01\x1f\x7f"s)), "\"\\u0001\\u001f\x7f\"");
+    EXPECT_EQ(json::dump(json::value("nul \0 byte"s)), R"("nul \u0000 byte")");
+    EXPECT_EQ(json::dump(json::value("caf\xC3\xA9 \xF0\x9F\x98\x80"s)), "\"caf\xC3\xA9 \xF0\x9F\x98\x80\"");
+
+    // Escapes found past the first SIMD block, and at block boundaries
+    for (auto n : {15, 16, 31, 32, 33, 64, 100}) {
+        const auto a = std::string(std::size_t(n), 'a');
+        const auto b = std::string(std::size_t(n), 'b');
+        auto expected = std::string("\"");
+        expected.append(a).append("\\\"").append(b).append("\\n\"");
+        EXPECT_EQ(json::dump(json::value(a + '"' + b + '\n')), expected);
+    }
+
+    auto obj = json::value(json::object{{"key \"quoted\"", 1_value}});
+    EXPECT_EQ(json::dump(obj), R"({"key \"quoted\"":1})");
+}
+
+TEST(serializer_test, round_trip) {
+    constexpr auto s = R"({"a": [1, -2.5, 3.0, true, false, null, "x\ty", {"nested": [[], {}]}],
+                          "b": "\u00e9\ud83d\ude00", "c": 1e-7, "\"key\"": "\\"})"sv;
+    const auto val = *json::parse(s);
+    const auto text = json::dump(val);
+    EXPECT_EQ(*json::parse(text), val);
+    // Insertion ordered objects reproduce the text exactly
+    const auto ordered_text = json::dump(*json::parse<json::ordered_value>(s));
+    EXPECT_EQ(json::dump(*json::parse<json::ordered_value>(ordered_text)), ordered_text);
+
+    // Every value flavour writes the same text
+    const auto ordered = R"({"z":[1,2.5,"s"],"a":{"b":null}})"sv;
+    EXPECT_EQ(json::dump(*json::parse<json::ordered_value>(ordered)), ordered);
+    EXPECT_EQ(json::dump(*json::parse<json::compact::value>(R"(["compact","a longer compact string"])")),
+              R"(["compact","a longer compact string"])");
+
+    auto os = std::ostringstream();
+    os << val;
+    EXPECT_EQ(os.str(), text);
+}
+
+TEST(serializer_test, appends) {
+    auto out = std::string("prefix ");
+    json::dump(json::value(json::array{1_value, "two"_value}), out);
+    EXPECT_EQ(out, R"(prefix [1,"two"])");
+}
+
+// Every integer digit count and sign, and doubles drawn from the whole bit space, come back
+// exactly after dump then parse
+TEST(serializer_test, number_round_trip) {
+    auto ints = std::vector<std::int64_t>{0, -1, std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()};
+    for (auto p = std::int64_t(1); p <= std::numeric_limits<std::int64_t>::max() / 10; p *= 10) {
+        for (auto i : {p - 1, p, p + 1, 7 * p}) {
+            ints.push_back(i);
+            ints.push_back(-i);
+        }
+    }
+    for (auto i : ints) {
+        const auto text = json::dump(json::value(i));
+        EXPECT_EQ(text, std::to_string(i));
+        EXPECT_EQ(json::parse(text)->get_int(), i);
+    }
+
+    auto doubles = std::vector<double>{0.0, -0.0, 0.1, 1.0 / 3.0, 5e-324, 2.2250738585072014e-308, 1.7976931348623157e308, 9007199254740993.0};
+    auto gen = std::mt19937_64(42);
+    for (auto i = 0; i < 100'000; i++) {
+        const auto d = std::bit_cast<double>(gen());
+        if (std::isfinite(d)) {
+            doubles.push_back(d);
+        }
+    }
+    for (auto d : doubles) {
+        const auto text = json::dump(json::value(d));
+        const auto val = json::parse(text);
+        ASSERT_TRUE(val) << text;
+        ASSERT_TRUE(val->holds<double>()) << text;
+        ASSERT_EQ(std::bit_cast<std::uint64_t>(val->get_float()), std::bit_cast<std::uint64_t>(d)) << text;
+    }
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "../include/meejson/stream.hpp"
+#include "../include/meejson/serializer.hpp"
+
+#include <string>
+#include <vector>
+
+namespace json = mee::json;
+
+using namespace std::literals;
+
+namespace {
+
+auto lines(std::size_t n) -> std::string {
+    auto s = std::string();
+    for (auto i = std::size_t(0); i < n; i++) {
+        s += R"({"id": )" + std::to_string(i) + R"(, "tags": ["a\nb", "]"], "nested": {"x": [1, 2, {"y": null}]}})" + "\n";
+    }
+    return s;
+}
+
+}
+
+TEST(stream_test, ndjson) {
+    const auto s = lines(500);
+    for (const auto threads : {1u, 2u, 4u}) {
+        for (const auto batch_size : {1u, 100u, 4096u, 1u << 20}) {
+            const auto results = json::parse_many(s, {.threads = threads, .batch_size = batch_size});
+            ASSERT_EQ(results.size(), 500u);
+            for (auto i = std::size_t(0); i < results.size(); i++) {
+                ASSERT_TRUE(results[i]) << results[i].error().what();
+                EXPECT_EQ((*results[i])["id"].get_int(), std::int64_t(i));
+                EXPECT_EQ((*results[i])["tags"][0].get_string(), "a\nb");
+            }
+        }
+    }
+}
+
+TEST(stream_test, concatenated) {
+    // Values back to back, some spanning lines and so crossing batches
+    const auto s = "3 5{}[]\"s\"\n{\n  \"a\": [\n    1,\n    2\n  ]\n}\n\n  [true,\nfalse] null\n-1.5"sv;
+    const auto expected = std::vector{*json::parse("3"), *json::parse("5"), *json::parse("{}"), *json::parse("[]"), *json::parse("\"s\""),
+                                      *json::parse(R"({"a": [1, 2]})"), *json::parse("[true, false]"), *json::parse("null"), *json::parse("-1.5")};
+    for (const auto threads : {1u, 3u}) {
+        for (const auto batch_size : {1u, 5u, 16u, 1024u}) {
+            const auto results = json::parse_many(s, {.threads = threads, .batch_size = batch_size});
+            ASSERT_EQ(results.size(), expected.size()) << batch_size;
+            for (auto i = std::size_t(0); i < results.size(); i++) {
+                ASSERT_TRUE(results[i]) << results[i].error().what();
+                EXPECT_EQ(*results[i], expected[i]) << i << ' ' << batch_size;
+            }
+        }
+    }
+    EXPECT_TRUE(json::parse_many("").empty());
+    EXPECT_TRUE(json::parse_many(" \n\n ").empty());
+}
+
+TEST(stream_test, errors) {
+    // A bad value is reported with its line in the whole input, and parsing carries on at the next line
+    const auto s = "[1]\n{\"a\": }\n[2, \"x\n[3] [4\n[5]\n"sv;
+    for (const auto threads : {1u, 2u}) {
+        for (const auto batch_size : {1u, 8u, 1024u}) {
+            const auto results = json::parse_many(s, {.threads = threads, .batch_size = batch_size});
+            ASSERT_EQ(results.size(), 6u) << batch_size;
+            EXPECT_EQ(*results[0], *json::parse("[1]"));
+            ASSERT_FALSE(results[1]);
+            EXPECT_EQ(results[1].error().line, 2);
+            EXPECT_EQ(results[1].error().msg, json::parse("{\"a\": }").error().msg);
+            ASSERT_FALSE(results[2]);
+            EXPECT_EQ(results[2].error().line, 3);
+            EXPECT_EQ(*results[3], *json::parse("[3]"));
+            ASSERT_FALSE(results[4]);
+            EXPECT_EQ(results[4].error().line, 5);
+            EXPECT_EQ(results[4].error().msg, "Unexpected token '[' Expected ','");
+            EXPECT_EQ(*results[5], *json::parse("[5]"));
+        }
+    }
+}
+
+TEST(stream_test, stop) {
+    const auto s = lines(100);
+    auto seen = 0;
+    json::parse_many(s, [&seen](json::result<json::value>&& res) {
+        EXPECT_TRUE(res);
+        return ++seen < 10;
+    }, {.threads = 4, .batch_size = 64});
+    EXPECT_EQ(seen, 10);
+}
@@ -207,4 +207,121 @@ TEST(value_test, arithmetic) {
 TEST(value_test, assignment) {
 
 
-}
\ No newline at end of file
+}
+TEST(value_test, array) {
+    auto arr = json::array{3_value, 1.5_value, 2_value, -1_value};
+    // Elements sit next to each other rather than behind pointers
+    EXPECT_EQ(&arr[1], &arr[0] + 1);
+    EXPECT_EQ(&*(arr.begin() + 3), &arr.back());
+
+    std::ranges::sort(arr);
+    EXPECT_EQ(arr, (json::array{-1_value, 1.5_value, 2_value, 3_value}));
+
+    arr.insert(arr.begin() + 1, 0_value);
+    arr.erase(arr.begin());
+    arr.emplace(arr.end(), "end"_value);
+    EXPECT_EQ(arr, (json::array{0_value, 1.5_value, 2_value, 3_value, "end"_value}));
+
+    arr.resize(2);
+    arr.resize(4, json::value(true));
+    EXPECT_EQ(arr, (json::array{0_value, 1.5_value, json::value(true), json::value(true)}));
+    EXPECT_GE(arr.capacity(), arr.size());
+
+    auto other = json::array{json::value(json::array{1_value})};
+    swap(arr, other);
+    EXPECT_EQ(arr.size(), 1u);
+    EXPECT_EQ(other.size(), 4u);
+    EXPECT_EQ(arr.front().get_array().front(), 1_value);
+
+    auto copy = other;
+    copy[0] = "changed"_value;
+    EXPECT_EQ(other[0], 0_value);
+}
+
+TEST(value_test, object_lookup) {
+    constexpr auto long_key = "a key longer than the small string buffer"sv;
+    auto obj = json::object();
+    obj.emplace(std::string(long_key), 1_value);
+    obj.emplace("short", 2_value);
+
+    EXPECT_TRUE(obj.contains(long_key));
+    EXPECT_TRUE(obj.contains("short"));
+    EXPECT_TRUE(obj.contains(json::hashed_key("short")));
+    EXPECT_FALSE(obj.contains(json::hashed_key("missing")));
+    EXPECT_EQ(obj.find(json::hashed_key(long_key))->second(), 1_value);
+    EXPECT_EQ(obj.at("short"), 2_value);
+    EXPECT_THROW(obj.at("missing"sv), std::out_of_range);
+    EXPECT_EQ(json::hashed_key("short").hash, json::object::hasher()("short"));
+
+    auto val = json::value(std::move(obj));
+    EXPECT_EQ(val[long_key], 1_value);
+    EXPECT_EQ(std::as_const(val)[json::hashed_key("short")], 2_value);
+    EXPECT_TRUE(val.has_key(json::hashed_key(long_key)));
+    EXPECT_THROW(val["missing"], json::invalid_access);
+
+    EXPECT_TRUE(val.get_object().erase(json::hashed_key(long_key)));
+    EXPECT_FALSE(val.get_object().erase(long_key));
+    EXPECT_EQ(val.get_object().size(), 1u);
+}
+
+TEST(value_test, find) {
+    auto val = json::value(json::object{{"id", 7_value}, {"items", json::value(json::array{1_value, json::value(json::object{{"name", "x"_value}})})}});
+    const auto& cval = val;
+
+    EXPECT_EQ(*cval.find("id"), 7_value);
+    EXPECT_EQ(*cval.find("id"_key), 7_value);
+    EXPECT_FALSE(cval.find("missing"));
+    EXPECT_FALSE(cval.find(0));
+    EXPECT_FALSE(cval["id"].find("id"));
+    EXPECT_EQ(*cval["items"].find(0), 1_value);
+    EXPECT_FALSE(cval["items"].find(2));
+    EXPECT_FALSE(cval["items"].find("name"));
+
+    EXPECT_EQ(cval.at_path("items", 1, "name"_key)->get_string(), "x");
+    EXPECT_FALSE(cval.at_path("items", 2, "name"));
+    EXPECT_FALSE(cval.at_path("items", 0, "name"));
+    EXPECT_EQ(&*cval.at_path(), &cval);
+
+    *val.at_path("items", 0) = 2_value;
+    *val.find("id") = 8_value;
+    EXPECT_EQ(val["items"][0], 2_value);
+    EXPECT_EQ(val["id"], 8_value);
+}
+
+TEST(value_test, as) {
+    EXPECT_EQ(*json::value(true).as<bool>(), true);
+    EXPECT_EQ(*json::value(std::int64_t(300)).as<int>(), 300);
+    EXPECT_EQ(json::value(std::int64_t(300)).as<std::int8_t>().error(), json::access_error::out_of_range);
+    EXPECT_EQ(json::value(std::int64_t(-1)).as<unsigned>().error(), json::access_error::out_of_range);
+    EXPECT_EQ(*json::value(std::int64_t(2)).as<double>(), 2.0);
+    EXPECT_EQ(json::value(2.5).as<std::int64_t>().error(), json::access_error::wrong_type);
+    EXPECT_EQ(*json::value("text"sv).as<std::string_view>(), "text"sv);
+    EXPECT_EQ(json::value().as<bool>().error(), json::access_error::wrong_type);
+    EXPECT_EQ(json::value(1.5).as<std::string_view>().value_or("none"), "none"sv);
+
+    auto val = json::value(json::object{{"id", 7_value}, {"name", "x"_value}});
+    EXPECT_EQ(val.get_or("id", 0), 7);
+    EXPECT_EQ(val.get_or("name", 0), 0);
+    EXPECT_EQ(val.get_or("missing", 1.5), 1.5);
+    EXPECT_EQ(val.get_or("name"_key, ""), "x"sv);
+    EXPECT_EQ(val.get_or("missing", "default"), "default"sv);
+    EXPECT_EQ(json::value(json::array{1_value}).get_or(0, std::int64_t(-1)), 1);
+    EXPECT_EQ(json::value(json::array{1_value}).get_or(1, std::int64_t(-1)), -1);
+
+    auto b = json::value(false);
+    *b.get_if_bool() = true;
+    EXPECT_EQ(b, json::value(true));
+}
+
+TEST(value_test, key_literal) {
+    static_assert(("user_id"_key).key == "user_id"sv);
+    static_assert(("user_id"_key).hash == json::detail::hash_key("user_id"));
+    static_assert(("user_id"_key).hash != ("user_ie"_key).hash);
+
+    auto val = json::value(json::object{{"user_id", 7_value}, {"name", "x"_value}});
+    EXPECT_EQ(val["user_id"_key], 7_value);
+    EXPECT_TRUE(val.has_key("name"_key));
+    EXPECT_FALSE(val.has_key("missing"_key));
+    EXPECT_THROW(val["missing"_key], json::invalid_access);
+    EXPECT_EQ(val.get_object().at("name"_key), "x"_value);
+}